@@ -0,0 +1,105 @@
+#include "AllPassBank.h"
+
+namespace process {
+    //==============================================================================
+    AllPassBank::AllPassBank() {
+        // a coefficient of 1 is an identity allpass, the cutoff sitting at nyquist
+        for (auto& row : coefficients) {
+            std::fill(std::begin(row), std::end(row), 1.f);
+        }
+
+        reset();
+    }
+
+    void AllPassBank::prepare(const CoefficientTables& newTables) {
+        tables = &newTables;
+        reset();
+    }
+
+    void AllPassBank::reset() noexcept {
+        for (auto& row : states) {
+            std::fill(std::begin(row), std::end(row), 0.f);
+        }
+    }
+
+    void AllPassBank::setNumStages(int newNumStages) noexcept {
+        newNumStages = jlimit(minStages, maxStages, newNumStages);
+
+        // stages coming back into the cascade must not replay stale state
+        for (int stage = numStages; stage < newNumStages; ++stage) {
+            std::fill(std::begin(states[stage]), std::end(states[stage]), 0.f);
+        }
+
+        numStages = newNumStages;
+    }
+
+    void AllPassBank::setCutoffPosition(int channel, float position, float spreadInOctaves) noexcept {
+        jassert(isPositiveAndBelow(channel, 2));
+        jassert(tables != nullptr);
+
+        for (int stage = 0; stage < numStages; ++stage) {
+            coefficients[stage][channel] = getCoefficient(*tables, position, spreadInOctaves, stage, numStages);
+        }
+    }
+
+    float AllPassBank::getCoefficient(const CoefficientTables& tables, float position, float spreadInOctaves, int stage, int numStages) noexcept {
+        // one octave in table positions
+        const auto octave = 0.30103f / tables.getLogNyquist();
+        const auto offset = 2.f * (float)stage / (float)(numStages - 1) - 1.f;
+
+        return tables.getAllPassCoefficient(position + offset * spreadInOctaves * octave);
+    }
+
+    //==============================================================================
+    // y = a * x + s, s = x - a * y, i.e. H(z) = (a + z^-1) / (1 + a * z^-1)
+    void AllPassBank::process(float* left, float* right, int numSamples) noexcept {
+       #if JUCE_USE_SIMD
+        Register a[maxStages];
+        Register s[maxStages];
+
+        for (int stage = 0; stage < numStages; ++stage) {
+            a[stage] = Register::fromRawArray(coefficients[stage]);
+            s[stage] = Register::fromRawArray(states[stage]);
+        }
+
+        alignas(laneAlignment) float frame[numLanes] {};
+
+        for (int i = 0; i < numSamples; ++i) {
+            frame[0] = left[i];
+            frame[1] = right[i];
+
+            auto x = Register::fromRawArray(frame);
+
+            for (int stage = 0; stage < numStages; ++stage) {
+                const auto y = a[stage] * x + s[stage];
+                s[stage] = x - a[stage] * y;
+                x = y;
+            }
+
+            x.copyToRawArray(frame);
+            left[i] = frame[0];
+            right[i] = frame[1];
+        }
+
+        for (int stage = 0; stage < numStages; ++stage) {
+            s[stage].copyToRawArray(states[stage]);
+        }
+       #else
+        float* io[2] = {left, right};
+
+        for (int ch = 0; ch < 2; ++ch) {
+            for (int i = 0; i < numSamples; ++i) {
+                auto x = io[ch][i];
+
+                for (int stage = 0; stage < numStages; ++stage) {
+                    const auto y = coefficients[stage][ch] * x + states[stage][ch];
+                    states[stage][ch] = x - coefficients[stage][ch] * y;
+                    x = y;
+                }
+
+                io[ch][i] = x;
+            }
+        }
+       #endif
+    }
+}
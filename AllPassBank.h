@@ -0,0 +1,55 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "Coefficients.h"
+
+namespace process {
+    //==============================================================================
+    // Cascade of first-order allpasses for both channels. Coefficients and states
+    // are kept as structure-of-arrays, one row per stage with a lane per channel,
+    // so a single SIMD register carries L and R through every stage.
+    class AllPassBank {
+    public:
+        static constexpr int minStages = 2;
+        static constexpr int maxStages = 16;
+
+        AllPassBank();
+
+        void prepare(const CoefficientTables&);
+        void reset() noexcept;
+
+        void setNumStages(int newNumStages) noexcept;
+        int getNumStages() const noexcept { return numStages; }
+
+        // position is log10(cutoff) / log10(nyquist), stage cutoffs are spread
+        // geometrically over +/- spreadInOctaves around it
+        void setCutoffPosition(int channel, float position, float spreadInOctaves) noexcept;
+
+        // the coefficient setCutoffPosition() gives a stage
+        static float getCoefficient(const CoefficientTables&, float position, float spreadInOctaves, int stage, int numStages) noexcept;
+
+        void process(float* left, float* right, int numSamples) noexcept;
+
+    private:
+        //==============================================================================
+       #if JUCE_USE_SIMD
+        using Register = dsp::SIMDRegister<float>;
+        static constexpr size_t numLanes = Register::SIMDNumElements;
+        static constexpr size_t laneAlignment = Register::SIMDRegisterSize;
+       #else
+        static constexpr size_t numLanes = 2;
+        static constexpr size_t laneAlignment = alignof(float);
+       #endif
+
+        //==============================================================================
+        alignas(laneAlignment) float coefficients[maxStages][numLanes];
+        alignas(laneAlignment) float states[maxStages][numLanes];
+
+        const CoefficientTables* tables { nullptr };
+        int numStages { minStages };
+
+        //==============================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AllPassBank)
+    };
+}
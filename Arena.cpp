@@ -0,0 +1,100 @@
+#include "Arena.h"
+
+#if JUCE_MAC || JUCE_LINUX || JUCE_BSD
+ #include <sys/mman.h>
+#endif
+
+namespace process {
+    //==============================================================================
+    Arena::~Arena() {
+        release();
+    }
+
+    void Arena::allocate(size_t totalBytes, bool lockPages) {
+        release();
+
+        capacity = pad(totalBytes);
+        storage.calloc(capacity + alignment);
+
+        const auto address = reinterpret_cast<uintptr_t>(storage.get());
+        base = storage.get() + (pad(address) - address);
+
+        // NOTE: a large calloc is mapped lazily, each page faulting in on its
+        // first write. The stores are volatile so they can't be dropped as
+        // writing zeros over zeros.
+        auto* bytes = static_cast<volatile char*>(storage.get());
+
+        for (size_t i = 0; i < capacity + alignment; i += pageBytes) {
+            bytes[i] = 0;
+        }
+
+       #if JUCE_MAC || JUCE_LINUX || JUCE_BSD
+        locked = lockPages && mlock(storage.get(), capacity + alignment) == 0;
+       #else
+        ignoreUnused(lockPages);
+       #endif
+    }
+
+    void Arena::release() {
+        destroyObjects();
+
+        sections.clear();
+        currentSection = 0;
+
+       #if JUCE_MAC || JUCE_LINUX || JUCE_BSD
+        if (locked) {
+            munlock(storage.get(), capacity + alignment);
+        }
+       #endif
+
+        locked = false;
+        storage.free();
+
+        base = nullptr;
+        capacity = used = 0;
+    }
+
+    void Arena::clear() noexcept {
+        destroyObjects();
+
+        sections.clear();
+        currentSection = 0;
+
+        zeromem(base, used);
+        used = 0;
+    }
+
+    void Arena::destroyObjects() noexcept {
+        // last created, first destroyed, like members
+        for (auto it = objects.rbegin(); it != objects.rend(); ++it) {
+            it->second(it->first);
+        }
+
+        objects.clear();
+    }
+
+    void Arena::beginSection(const String& name) {
+        for (currentSection = 0; currentSection < sections.size(); ++currentSection) {
+            if (sections[currentSection].name == name) {
+                return;
+            }
+        }
+
+        sections.push_back({name, 0});
+    }
+
+    void* Arena::takeBytes(size_t bytes) noexcept {
+        // the owner sized the block from the same sizeFor() calls the stages take with
+        jassert(used + bytes <= capacity);
+
+        if (sections.empty()) {
+            beginSection("Other");
+        }
+
+        auto* piece = base + used;
+        used += bytes;
+        sections[currentSection].bytes += bytes;
+
+        return piece;
+    }
+}
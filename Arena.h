@@ -0,0 +1,98 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace process {
+    //==============================================================================
+    // One cache-line-aligned block holding all audio-thread state of an instance.
+    // The owner adds up what every stage needs, allocates once at prepare time,
+    // and the stages then take their pieces in order, hot state first. Every
+    // piece starts on its own cache line, and the bytes are booked per section
+    // for the memory report.
+    //
+    // The block is written through once when it's allocated, so the first
+    // blocks on the audio thread don't pay for page faults, and can be locked
+    // into RAM on top.
+    class Arena {
+    public:
+        static constexpr size_t alignment = 64;
+
+        // the smallest page size on anything we run on; touching once per this
+        // many bytes faults every page in
+        static constexpr size_t pageBytes = 4096;
+
+        struct Section {
+            String name;
+            size_t bytes { 0 };
+        };
+
+        Arena() = default;
+        ~Arena();
+
+        static constexpr size_t pad(size_t bytes) noexcept {
+            return (bytes + alignment - 1) & ~(alignment - 1);
+        }
+
+        template <typename T>
+        static constexpr size_t sizeFor(size_t count = 1) noexcept {
+            return pad(sizeof(T) * count);
+        }
+
+        // destroys whatever was created in the old block and hands out a zeroed
+        // new one; lockPages also asks the OS to keep it out of swap, which may
+        // be refused, see isLocked()
+        void allocate(size_t totalBytes, bool lockPages = false);
+        void release();
+
+        // destroys whatever was created and zeroes the block for a new round of
+        // takes, in the same memory
+        void clear() noexcept;
+
+        // following takes are booked under this name, added to any earlier takes under it
+        void beginSection(const String& name);
+
+        // zeroed storage for count trivially destructible values
+        template <typename T>
+        T* take(size_t count = 1) noexcept {
+            static_assert(std::is_trivially_destructible<T>::value, "use create() for objects");
+            static_assert(alignof(T) <= alignment, "over-aligned type");
+            return static_cast<T*>(takeBytes(sizeFor<T>(count)));
+        }
+
+        // constructs an object in place, destroyed by the next allocate() or release()
+        template <typename T, typename... Args>
+        T* create(Args&&... args) {
+            static_assert(alignof(T) <= alignment, "over-aligned type");
+            auto* object = new (takeBytes(sizeFor<T>())) T(std::forward<Args>(args)...);
+            objects.push_back({object, [](void* o) { static_cast<T*>(o)->~T(); }});
+            return object;
+        }
+
+        size_t getCapacity() const noexcept { return capacity; }
+        bool isLocked() const noexcept { return locked; }
+        size_t getBytesUsed() const noexcept { return used; }
+        const std::vector<Section>& getSections() const noexcept { return sections; }
+
+    private:
+        //==============================================================================
+        void* takeBytes(size_t bytes) noexcept;
+        void destroyObjects() noexcept;
+
+        HeapBlock<char> storage;
+        char* base { nullptr };
+        size_t capacity { 0 };
+        size_t used { 0 };
+        bool locked { false };
+
+        std::vector<Section> sections;
+        size_t currentSection { 0 };
+        std::vector<std::pair<void*, void (*)(void*)>> objects;
+
+        //==============================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Arena)
+    };
+}
@@ -0,0 +1,242 @@
+#include "ChunkedRenderer.h"
+#include <numeric>
+
+#include "Processors.h"
+
+//==============================================================================
+ChunkedRenderer::ChunkedRenderer(const File& inputFile, Options newOptions)
+    : input(inputFile)
+    , options(std::move(newOptions))
+    , pool(options.numThreads)
+{
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(input));
+
+    if (reader == nullptr) {
+        ConsoleApplication::fail("Can't read " + input.getFullPathName());
+    }
+
+    sampleRate = reader->sampleRate;
+    lengthInSamples = reader->lengthInSamples;
+}
+
+ChunkedRenderer::~ChunkedRenderer() {
+}
+
+std::unique_ptr<AudioPluginAudioProcessor> ChunkedRenderer::createProcessor() const {
+    auto processor = std::make_unique<AudioPluginAudioProcessor>();
+
+    if (options.state.getSize() > 0) {
+        processor->setStateInformation(options.state.getData(), (int)options.state.getSize());
+    }
+
+    // no deadline, so the load governor stays out of it and every chunk renders at full quality
+    processor->setNonRealtime(true);
+    processor->setPlayConfigDetails(2, 2, sampleRate, options.blockSize);
+    processor->prepareToPlay(sampleRate, options.blockSize);
+
+    return processor;
+}
+
+// chunk and pre-roll starts land on block and STFT hop boundaries of the single pass
+int ChunkedRenderer::getAlignment() const {
+    return std::lcm(options.blockSize, process::SpectralShaper::fftSize);
+}
+
+int64 ChunkedRenderer::getChunkLength() const {
+    const auto alignment = (int64)getAlignment();
+    const auto length = (int64)(options.chunkSeconds * sampleRate);
+
+    return jmax(alignment, (length / alignment) * alignment);
+}
+
+//==============================================================================
+int ChunkedRenderer::detectWarmUpSamples() {
+    // at least long enough for the slowest parameter ramp (the Fx smoothers step
+    // once a block over blockSize / 8 blocks), a few STFT frames and the longest delay
+    const auto minimumProbe = (int)jmax(4. * sampleRate,
+                                        2. * (options.blockSize * (options.blockSize / 8 + 1)
+                                              + 4 * process::SpectralShaper::fftSize
+                                              + sampleRate * process::FxProcessor::maxDelayInMilliseconds * 0.001));
+
+    // very low, many-stage allpasses ring for a while, so the probe grows until it sees convergence
+    for (auto probeLength = minimumProbe; probeLength <= 16 * minimumProbe; probeLength *= 2) {
+        const auto lastDifference = findLastDifference(probeLength);
+
+        if (lastDifference < probeLength / 2) {
+            // whole alignment steps, so chunk pre-rolls line up with the single pass
+            const auto alignment = getAlignment();
+            return ((lastDifference + alignment) / alignment) * alignment;
+        }
+    }
+
+    ConsoleApplication::fail("The chain did not converge within " + String(16 * minimumProbe) + " samples");
+    return 0;
+}
+
+// the same noise probe through a settled instance and through a fresh one
+int ChunkedRenderer::findLastDifference(int probeLength) const {
+    Random random(1);
+    const auto fillNoise = [&random](AudioBuffer<float>& buffer) {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+            for (int i = 0; i < buffer.getNumSamples(); ++i) {
+                buffer.setSample(ch, i, 0.5f * (2.f * random.nextFloat() - 1.f));
+            }
+        }
+    };
+
+    AudioBuffer<float> history(2, (int)(2. * sampleRate));
+    AudioBuffer<float> probe(2, probeLength);
+    fillNoise(history);
+    fillNoise(probe);
+
+    AudioBuffer<float> settledOutput, freshOutput;
+    auto settled = createProcessor();
+    auto fresh = createProcessor();
+    MidiBuffer midi;
+
+    const auto runThrough = [this, &midi](AudioPluginAudioProcessor& processor, const AudioBuffer<float>& source, AudioBuffer<float>* result) {
+        AudioBuffer<float> block(2, options.blockSize);
+
+        if (result != nullptr) {
+            result->setSize(2, source.getNumSamples());
+        }
+
+        for (int start = 0; start < source.getNumSamples(); start += options.blockSize) {
+            const auto n = jmin(options.blockSize, source.getNumSamples() - start);
+            block.setSize(2, n, false, false, true);
+
+            for (int ch = 0; ch < 2; ++ch) {
+                block.copyFrom(ch, 0, source, ch, start, n);
+            }
+
+            processor.processBlock(block, midi);
+
+            if (result != nullptr) {
+                for (int ch = 0; ch < 2; ++ch) {
+                    result->copyFrom(ch, start, block, ch, 0, n);
+                }
+            }
+        }
+    };
+
+    runThrough(*settled, history, nullptr);
+    runThrough(*settled, probe, &settledOutput);
+    runThrough(*fresh, probe, &freshOutput);
+
+    int lastDifference = -1;
+
+    for (int ch = 0; ch < 2; ++ch) {
+        for (int i = 0; i < probeLength; ++i) {
+            if (std::abs(settledOutput.getSample(ch, i) - freshOutput.getSample(ch, i)) > 0.1f * options.tolerance) {
+                lastDifference = jmax(lastDifference, i);
+            }
+        }
+    }
+
+    return lastDifference;
+}
+
+//==============================================================================
+void ChunkedRenderer::renderRange(AudioFormatReader* reader, int64 start, int64 end, int warmUp, AudioBuffer<float>& destination) const {
+    auto processor = createProcessor();
+    const auto latency = (int64)processor->getLatencySamples();
+
+    const auto from = jmax((int64)0, start - warmUp);
+    const auto to = end + latency;
+
+    AudioBuffer<float> block(2, options.blockSize);
+    MidiBuffer midi;
+
+    destination.setSize(2, (int)(end - start), false, false, true);
+
+    for (auto position = from; position < to; position += options.blockSize) {
+        const auto n = (int)jmin((int64)options.blockSize, to - position);
+        block.setSize(2, n, false, false, true);
+
+        // past the end of the file this reads silence, flushing the latency out
+        reader->read(&block, 0, n, position, true, true);
+        processor->processBlock(block, midi);
+
+        // block sample i is output sample position + i - latency
+        const auto first = jmax(start, position - latency);
+        const auto last = jmin(end, position + n - latency);
+
+        for (auto t = first; t < last; ++t) {
+            for (int ch = 0; ch < 2; ++ch) {
+                destination.setSample(ch, (int)(t - start), block.getSample(ch, (int)(t + latency - position)));
+            }
+        }
+    }
+
+    numQualityTransitions += processor->getNumQualityTransitions();
+    processor->releaseResources();
+}
+
+void ChunkedRenderer::renderSingleThreaded(AudioBuffer<float>& destination) {
+    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(input));
+    renderRange(reader.get(), 0, lengthInSamples, 0, destination);
+}
+
+void ChunkedRenderer::renderChunked(AudioBuffer<float>& destination, int warmUpSamples) {
+    destination.setSize(2, (int)lengthInSamples);
+
+    const auto chunkLength = getChunkLength();
+
+    std::vector<AudioBuffer<float>> chunks((size_t)((lengthInSamples + chunkLength - 1) / chunkLength));
+    std::vector<WorkStealingPool::Job> jobs;
+
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        jobs.emplace_back([this, i, chunkLength, warmUpSamples, &chunks] {
+            std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(input));
+            const auto start = (int64)i * chunkLength;
+            renderRange(reader.get(), start, jmin(lengthInSamples, start + chunkLength), warmUpSamples, chunks[i]);
+        });
+    }
+
+    pool.runBatch(jobs);
+
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        for (int ch = 0; ch < 2; ++ch) {
+            destination.copyFrom(ch, (int)((int64)i * chunkLength), chunks[i], ch, 0, chunks[i].getNumSamples());
+        }
+    }
+}
+
+double ChunkedRenderer::render(AudioFormatWriter& writer, int warmUpSamples) {
+    const auto startTime = Time::getMillisecondCounterHiRes();
+    const auto chunkLength = getChunkLength();
+
+    // one chunk per worker at a time, written out in order before the next batch
+    std::vector<AudioBuffer<float>> chunks((size_t)pool.getNumThreads());
+    std::vector<WorkStealingPool::Job> jobs;
+
+    for (int64 batchStart = 0; batchStart < lengthInSamples; batchStart += chunkLength * (int64)chunks.size()) {
+        jobs.clear();
+
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            const auto start = batchStart + (int64)i * chunkLength;
+
+            if (start >= lengthInSamples) {
+                chunks[i].setSize(2, 0);
+                continue;
+            }
+
+            jobs.emplace_back([this, i, start, chunkLength, warmUpSamples, &chunks] {
+                std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(input));
+                renderRange(reader.get(), start, jmin(lengthInSamples, start + chunkLength), warmUpSamples, chunks[i]);
+            });
+        }
+
+        pool.runBatch(jobs);
+
+        for (const auto& chunk : chunks) {
+            if (chunk.getNumSamples() > 0 && ! writer.writeFromAudioSampleBuffer(chunk, 0, chunk.getNumSamples())) {
+                ConsoleApplication::fail("Writing the output failed");
+            }
+        }
+    }
+
+    return (Time::getMillisecondCounterHiRes() - startTime) / 1000.;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+
+#include "PluginProcessor.h"
+#include "WorkStealingPool.h"
+
+//==============================================================================
+// Offline render of one long file, split into chunks rendered in parallel. The
+// chain only remembers a short stretch of its input (the delay ring, decaying
+// allpass state, an STFT frame) plus its parameter ramps, so each chunk gets a
+// fresh instance that is pre-rolled over the audio before the chunk until it
+// has converged to the state a single pass would have there. The pre-roll is
+// measured, not guessed: see detectWarmUpSamples().
+class ChunkedRenderer {
+public:
+    struct Options {
+        int blockSize { 512 };
+        int numThreads { SystemStats::getNumCpus() };
+        double chunkSeconds { 30. };
+        float tolerance { 1.e-5f };
+        MemoryBlock state;          // plugin state to render with, default parameters if empty
+    };
+
+    ChunkedRenderer(const File& input, Options);
+    ~ChunkedRenderer();
+
+    double getSampleRate() const noexcept { return sampleRate; }
+    int64 getLengthInSamples() const noexcept { return lengthInSamples; }
+
+    // samples of pre-roll after which a fresh instance matches a long-running one
+    // to within a tenth of the tolerance, on noise, at the render settings
+    int detectWarmUpSamples();
+
+    // renders chunks on the pool and writes them in order; returns the wall time in seconds
+    double render(AudioFormatWriter&, int warmUpSamples);
+
+    // the whole file through one instance, for checking a chunked render against
+    void renderSingleThreaded(AudioBuffer<float>&);
+
+    // the chunked render kept in memory, for the same check
+    void renderChunked(AudioBuffer<float>&, int warmUpSamples);
+
+    // summed over every instance rendered so far; offline, anything but 0 means
+    // some chunk ran below full quality
+    int getNumQualityTransitions() const noexcept { return numQualityTransitions.load(); }
+
+private:
+    //==============================================================================
+    std::unique_ptr<AudioPluginAudioProcessor> createProcessor() const;
+    int findLastDifference(int probeLength) const;
+
+    // output [start, end) with the plugin latency removed, pre-rolled from start - warmUp
+    void renderRange(AudioFormatReader*, int64 start, int64 end, int warmUp, AudioBuffer<float>& destination) const;
+
+    int getAlignment() const;
+    int64 getChunkLength() const;
+
+    //==============================================================================
+    const File input;
+    const Options options;
+
+    AudioFormatManager formatManager;
+    double sampleRate { 0. };
+    int64 lengthInSamples { 0 };
+
+    WorkStealingPool pool;
+    mutable std::atomic<int> numQualityTransitions { 0 };
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChunkedRenderer)
+};
@@ -0,0 +1,31 @@
+#include "Coefficients.h"
+
+namespace process {
+    //==============================================================================
+    CoefficientTables::CoefficientTables(double rate)
+        : sampleRate(rate)
+        , logNyquist((float)std::log10(rate / 2.))
+    {
+        const auto nyquistLimit = (float)sampleRate / 2.01f;
+
+        for (int i = 0; i <= allPassTableSize; ++i) {
+            const auto position = (float)i / (float)allPassTableSize;
+            const auto cutoff = jlimit(10.f, nyquistLimit, fastmath::pow10(position * logNyquist));
+            const auto g = fastmath::tan(MathConstants<float>::pi * cutoff / (float)sampleRate);
+
+            allPassTable[(size_t)i] = (g - 1.f) / (g + 1.f);
+        }
+
+        // same laws as dsp::PannerRule balanced/squareRoot3dB/squareRoot4p5dB/linear,
+        // including the boost that brings the centre back to unity
+        for (int i = 0; i <= panTableSize; ++i) {
+            const auto leftShare = 1.f - (float)i / (float)panTableSize;
+            const auto root = fastmath::sqrt(leftShare);
+
+            panTables[(size_t)PanLaw::Linear][(size_t)i] = jmin(1.f, 2.f * leftShare);
+            panTables[(size_t)PanLaw::Minus3dB][(size_t)i] = root * MathConstants<float>::sqrt2;
+            panTables[(size_t)PanLaw::Minus4p5dB][(size_t)i] = root * fastmath::sqrt(root) * 1.68179283f;
+            panTables[(size_t)PanLaw::Minus6dB][(size_t)i] = 2.f * leftShare;
+        }
+    }
+}
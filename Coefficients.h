@@ -0,0 +1,140 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include "SharedResources.h"
+
+namespace process {
+    //==============================================================================
+    // Polynomial/rational approximations with bounded relative error. The tables
+    // below are built with these, so preparing many instances at once stays cheap.
+    namespace fastmath {
+        // 2^x, relative error < 2e-6 over [-126, 127]
+        inline float exp2(float x) noexcept {
+            x = jlimit(-126.f, 127.f, x);
+
+            const auto whole = std::nearbyint(x);
+            const auto f = x - whole;
+
+            const auto p = 1.f + f * (0.69314718f + f * (0.24022651f + f * (0.055504109f
+                         + f * (0.0096181291f + f * (0.0013333558f + f * 0.00015403530f)))));
+
+            const auto bits = ((int32_t)whole + 127) << 23;
+            float scale;
+            std::memcpy(&scale, &bits, sizeof(float));
+
+            return p * scale;
+        }
+
+        // 10^x, relative error < 2e-6 for |x| < 38
+        inline float pow10(float x) noexcept {
+            return exp2(x * 3.32192809f);
+        }
+
+        // tan(x) for x in [0, pi/2), relative error < 2e-5
+        inline float tan(float x) noexcept {
+            const auto pade = [](float y) {
+                const auto y2 = y * y;
+                return y * (945.f - 105.f * y2 + y2 * y2) / (945.f - 420.f * y2 + 15.f * y2 * y2);
+            };
+
+            if (x <= MathConstants<float>::halfPi * 0.5f) {
+                return pade(x);
+            }
+
+            return 1.f / pade(MathConstants<float>::halfPi - x);
+        }
+
+        // sqrt(x) for x >= 0, relative error < 1e-6
+        inline float sqrt(float x) noexcept {
+            if (x <= 0.f) {
+                return 0.f;
+            }
+
+            int32_t bits;
+            std::memcpy(&bits, &x, sizeof(float));
+            bits = 0x5f3759df - (bits >> 1);
+
+            float y;
+            std::memcpy(&y, &bits, sizeof(float));
+
+            for (int i = 0; i < 3; ++i) {
+                y = y * (1.5f - 0.5f * x * y * y);
+            }
+
+            return x * y;
+        }
+    }
+
+    //==============================================================================
+    enum class PanLaw {
+        Linear = 0,     // balance, unity at centre
+        Minus3dB,
+        Minus4p5dB,
+        Minus6dB,
+    };
+
+    //==============================================================================
+    // Sample-rate specific parameter-to-coefficient tables, built once at prepare
+    // time and read with a lookup and a lerp.
+    class CoefficientTables {
+    public:
+        static constexpr int allPassTableSize = 2048;
+        static constexpr int panTableSize = 512;
+        static constexpr int numPanLaws = 4;
+
+        explicit CoefficientTables(double sampleRate);
+
+        double getSampleRate() const noexcept { return sampleRate; }
+        float getLogNyquist() const noexcept { return logNyquist; }
+
+        // position is log10(cutoff) / log10(nyquist), the cutoff is clamped to [10, fs / 2.01]
+        float getAllPassCoefficient(float position) const noexcept {
+            return lookup(allPassTable.data(), allPassTableSize, position);
+        }
+
+        // pan in [-1, 1], the centre is unity gain for every law
+        void getPanGains(PanLaw law, float pan, float& left, float& right) const noexcept {
+            const auto* table = panTables[(size_t)law].data();
+            const auto normalisedPan = 0.5f * (pan + 1.f);
+
+            left = lookup(table, panTableSize, normalisedPan);
+            right = lookup(table, panTableSize, 1.f - normalisedPan);
+        }
+
+    private:
+        //==============================================================================
+        static float lookup(const float* table, int size, float position) noexcept {
+            const auto index = jlimit(0.f, (float)size, position * (float)size);
+            const auto i = jmin((int)index, size - 1);
+            const auto frac = index - (float)i;
+
+            return table[i] + frac * (table[i + 1] - table[i]);
+        }
+
+        //==============================================================================
+        double sampleRate;
+        float logNyquist;
+
+        std::array<float, allPassTableSize + 1> allPassTable;
+
+        // left gain against normalised pan, the right gain reads it mirrored
+        std::array<std::array<float, panTableSize + 1>, numPanLaws> panTables;
+
+        //==============================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CoefficientTables)
+    };
+
+    //==============================================================================
+    // One set of tables per sample rate, shared by every instance in the process.
+    // Hold it through a SharedResourcePointer.
+    class CoefficientTableRegistry : public SharedResourceRegistry<double, CoefficientTables> {
+    public:
+        std::shared_ptr<const CoefficientTables> get(double sampleRate) {
+            return getOrCreate(sampleRate, [sampleRate] { return std::make_shared<CoefficientTables>(sampleRate); });
+        }
+    };
+}
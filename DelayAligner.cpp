@@ -0,0 +1,196 @@
+#include "DelayAligner.h"
+
+namespace process {
+    //==============================================================================
+    namespace {
+        constexpr float averaging = 0.3f;
+        constexpr float minConfidence = 6.f;
+        constexpr int windowsToConverge = 3;
+    }
+
+    DelayAligner::~DelayAligner() {
+        stop();
+    }
+
+    void DelayAligner::prepare(double sampleRate, int maxLagInSamples) {
+        jassert(! isRunning());
+
+        // about 1/8 s per window, and always several times the longest lag
+        windowSize = nextPowerOfTwo(jmax((int)(sampleRate / 8.), 4 * maxLagInSamples));
+        hopSize = windowSize / 2;
+        fftSize = 2 * windowSize;
+        maxLag = maxLagInSamples;
+
+        fft = fftRegistry->get(roundToInt(std::log2((double)fftSize)));
+
+        fifo.setTotalSize(4 * windowSize);
+
+        for (int ch = 0; ch < 2; ++ch) {
+            rings[ch].calloc((size_t)fifo.getTotalSize());
+            history[ch].calloc((size_t)windowSize);
+            frames[ch].calloc((size_t)fftSize * 2);
+        }
+
+        window.calloc((size_t)windowSize);
+        averageCross.calloc((size_t)fftSize + 2);
+
+        for (int i = 0; i < windowSize; ++i) {
+            window[i] = 0.5f - 0.5f * std::cos(MathConstants<float>::twoPi * (float)i / (float)windowSize);
+        }
+    }
+
+    void DelayAligner::start() {
+        if (windowSize == 0 || isRunning()) {
+            return;
+        }
+
+        // the audio thread only pushes once running is set
+        fifo.reset();
+        filled = runLength = lastLag = 0;
+        FloatVectorOperations::clear(averageCross, fftSize + 2);
+
+        {
+            const ScopedLock sl(estimateLock);
+            estimate = {};
+        }
+
+        running = true;
+        thread->addTimeSliceClient(this);
+    }
+
+    void DelayAligner::stop() {
+        if (running.exchange(false)) {
+            // waits for a running analysis to finish
+            thread->removeTimeSliceClient(this);
+        }
+    }
+
+    void DelayAligner::push(const float* left, const float* right, int numSamples) noexcept {
+        const auto scope = fifo.write(jmin(numSamples, fifo.getFreeSpace()));
+        const float* inputs[2] = {left, right};
+
+        for (int ch = 0; ch < 2; ++ch) {
+            if (scope.blockSize1 > 0) {
+                FloatVectorOperations::copy(rings[ch] + scope.startIndex1, inputs[ch], scope.blockSize1);
+            }
+
+            if (scope.blockSize2 > 0) {
+                FloatVectorOperations::copy(rings[ch] + scope.startIndex2, inputs[ch] + scope.blockSize1, scope.blockSize2);
+            }
+        }
+    }
+
+    DelayAligner::Estimate DelayAligner::getEstimate() const {
+        const ScopedLock sl(estimateLock);
+        return estimate;
+    }
+
+    //==============================================================================
+    int DelayAligner::useTimeSlice() {
+        while (fifo.getNumReady() >= hopSize) {
+            // slide the window on by one hop
+            for (int ch = 0; ch < 2; ++ch) {
+                std::memmove(history[ch], history[ch] + hopSize, sizeof(float) * (size_t)(windowSize - hopSize));
+            }
+
+            const auto scope = fifo.read(hopSize);
+
+            for (int ch = 0; ch < 2; ++ch) {
+                auto* tail = history[ch] + windowSize - hopSize;
+
+                FloatVectorOperations::copy(tail, rings[ch] + scope.startIndex1, scope.blockSize1);
+                FloatVectorOperations::copy(tail + scope.blockSize1, rings[ch] + scope.startIndex2, scope.blockSize2);
+            }
+
+            filled = jmin(windowSize, filled + hopSize);
+
+            if (filled == windowSize) {
+                analyseWindow();
+            }
+        }
+
+        return 20;
+    }
+
+    // IFFT(L * conj(R))[k] = sum l[n + k] r[n]: a right channel late by D peaks at k = -D
+    void DelayAligner::analyseWindow() {
+        for (int ch = 0; ch < 2; ++ch) {
+            auto* frame = frames[ch].get();
+
+            FloatVectorOperations::multiply(frame, history[ch], window, windowSize);
+            FloatVectorOperations::clear(frame + windowSize, 2 * fftSize - windowSize);
+
+            fft->performRealOnlyForwardTransform(frame, true);
+        }
+
+        // a silent window says nothing about the lag
+        float energy = 0.f;
+
+        for (int i = 0; i <= fftSize; ++i) {
+            energy += frames[0][i] * frames[0][i] + frames[1][i] * frames[1][i];
+        }
+
+        if (energy < 1.e-6f) {
+            return;
+        }
+
+        const auto* l = frames[0].get();
+        const auto* r = frames[1].get();
+        auto* correlation = frames[0].get();
+
+        for (int bin = 0; bin <= fftSize / 2; ++bin) {
+            const auto re = l[2 * bin] * r[2 * bin] + l[2 * bin + 1] * r[2 * bin + 1];
+            const auto im = l[2 * bin + 1] * r[2 * bin] - l[2 * bin] * r[2 * bin + 1];
+            const auto magnitude = std::sqrt(re * re + im * im) + 1.e-12f;
+
+            auto& averageRe = averageCross[2 * bin];
+            auto& averageIm = averageCross[2 * bin + 1];
+
+            averageRe += averaging * (re / magnitude - averageRe);
+            averageIm += averaging * (im / magnitude - averageIm);
+        }
+
+        FloatVectorOperations::copy(correlation, averageCross, fftSize + 2);
+        fft->performRealOnlyInverseTransform(correlation);
+
+        const auto at = [this, correlation](int lag) { return correlation[(lag + fftSize) % fftSize]; };
+
+        int peakLag = 0;
+        float peak = 0.f, sum = 0.f;
+
+        for (int lag = -maxLag; lag <= maxLag; ++lag) {
+            const auto value = std::abs(at(lag));
+            sum += value;
+
+            if (value > peak) {
+                peak = value;
+                peakLag = lag;
+            }
+        }
+
+        // parabolic interpolation of the peak for a fractional lag
+        auto fraction = 0.f;
+
+        if (std::abs(peakLag) < maxLag) {
+            const auto before = std::abs(at(peakLag - 1));
+            const auto after = std::abs(at(peakLag + 1));
+            const auto curvature = before - 2.f * peak + after;
+
+            if (curvature < 0.f) {
+                fraction = 0.5f * (before - after) / curvature;
+            }
+        }
+
+        const auto confidence = peak / (sum / (float)(2 * maxLag + 1) + 1.e-12f);
+
+        runLength = (std::abs(peakLag - lastLag) <= 1 && confidence >= minConfidence) ? runLength + 1 : 0;
+        lastLag = peakLag;
+
+        const ScopedLock sl(estimateLock);
+        estimate.lagInSamples = -((float)peakLag + fraction);
+        estimate.isInverted = at(peakLag) < 0.f;
+        estimate.confidence = confidence;
+        estimate.hasConverged = runLength >= windowsToConverge;
+        estimate.numWindows += 1;
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+
+#include "SpectralShaper.h"
+
+namespace process {
+    //==============================================================================
+    // One low-priority thread per process for background analysis.
+    class AnalysisThread : public TimeSliceThread {
+    public:
+        AnalysisThread() : TimeSliceThread("Pantheon analysis") { startThread(); }
+        ~AnalysisThread() override { stopThread(1000); }
+    };
+
+    //==============================================================================
+    // Estimates the lag and polarity between left and right. The audio thread only
+    // copies the input into a lock-free FIFO; the shared analysis thread reads it
+    // in half-overlapping windows and runs GCC-PHAT, a cross-correlation with the
+    // cross-spectrum whitened to unit magnitude so the peak stays sharp on tonal
+    // material, averaged over windows. The estimate has converged once the same
+    // lag wins a few windows in a row with a clear peak.
+    class DelayAligner : private TimeSliceClient {
+    public:
+        struct Estimate {
+            float lagInSamples { 0.f };     // > 0: right is late, left needs delaying
+            bool isInverted { false };
+            float confidence { 0.f };       // peak over the mean correlation in range
+            bool hasConverged { false };
+            int numWindows { 0 };
+        };
+
+        DelayAligner() = default;
+        ~DelayAligner() override;
+
+        // lags up to +/- maxLagInSamples are searched; not while running
+        void prepare(double sampleRate, int maxLagInSamples);
+
+        void start();
+        void stop();
+        bool isRunning() const noexcept { return running.load(std::memory_order_relaxed); }
+
+        // audio thread; drops what doesn't fit while the analysis catches up
+        void push(const float* left, const float* right, int numSamples) noexcept;
+
+        Estimate getEstimate() const;
+
+    private:
+        //==============================================================================
+        int useTimeSlice() override;
+        void analyseWindow();
+
+        //==============================================================================
+        std::atomic<bool> running { false };
+
+        int windowSize { 0 };
+        int hopSize { 0 };
+        int fftSize { 0 };
+        int maxLag { 0 };
+
+        AbstractFifo fifo { 1 };
+        HeapBlock<float> rings[2];
+
+        // analysis thread only
+        std::shared_ptr<const dsp::FFT> fft;
+        HeapBlock<float> history[2];
+        HeapBlock<float> frames[2];
+        HeapBlock<float> window;
+        HeapBlock<float> averageCross;
+        int filled { 0 };
+        int runLength { 0 };
+        int lastLag { 0 };
+
+        CriticalSection estimateLock;
+        Estimate estimate;
+
+        SharedResourcePointer<AnalysisThread> thread;
+        SharedResourcePointer<FftRegistry> fftRegistry;
+
+        //==============================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DelayAligner)
+    };
+}
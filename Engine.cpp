@@ -0,0 +1,372 @@
+#include "Engine.h"
+
+#include "Processors.h"
+
+namespace process {
+    //==============================================================================
+    Engine::Engine(const Parameters& values)
+        : parameters(values)
+    {
+    }
+
+    Engine::~Engine() {
+        release();
+    }
+
+    void Engine::prepare(const AudioChannelSet& layout, double sampleRate, int samplesPerBlock) {
+        jassert(layout.size() <= maxChannels);
+
+        numChannels = layout.size();
+
+        // the dry copy, a latency ring per channel and the crossfade gains
+        const auto bypassBytes = 2 * Arena::sizeFor<float*>((size_t)numChannels)
+                               + (size_t)numChannels * Arena::sizeFor<float>((size_t)samplesPerBlock)
+                               + (size_t)numChannels * Arena::sizeFor<float>(SpectralShaper::fftSize)
+                               + Arena::sizeFor<float>((size_t)samplesPerBlock);
+
+        arena.allocate(PreProcessor::getArenaBytes(layout, sampleRate, samplesPerBlock)
+                     + FxProcessor::getArenaBytes(layout, sampleRate, samplesPerBlock)
+                     + MixerProcessor::getArenaBytes(layout, sampleRate, samplesPerBlock)
+                     + SpectralProcessor::getArenaBytes(layout, sampleRate, samplesPerBlock)
+                     + StageFolder::getArenaBytes(layout, sampleRate, samplesPerBlock)
+                     + bypassBytes,
+                       locksMemory);
+
+        buildStages(layout, sampleRate, samplesPerBlock);
+
+        // then built afresh on the same memory, now resident and in cache
+        if (warmsUp) {
+            warmUp(samplesPerBlock);
+            arena.clear();
+            buildStages(layout, sampleRate, samplesPerBlock);
+        }
+
+        const auto isBypassed = parameters.get(ParameterId::bypass) > 0.5f;
+        wetGain.reset(sampleRate, bypassFadeMilliseconds * 0.001);
+        wetGain.setCurrentAndTargetValue(isBypassed ? 0.f : 1.f);
+        isFullyBypassed = isBypassed;
+        refillSamples = 0;
+        needsRefill = isBypassed;
+        fxMemoryInSamples = (int)std::ceil(sampleRate * FxProcessor::maxDelayInMilliseconds * 0.001);
+
+        wasSpectral = parameters.get(ParameterId::spectralMode) > 0.5f;
+        latencyInSamples = wasSpectral ? spectralProcessor->getLatencyInSamples() : 0;
+
+        // the level carries over, the load measurement starts again
+        governor.prepare(sampleRate);
+        applyQuality(governor.getQuality());
+
+        events.restart();
+        events.push(Event::Type::prepare, samplesPerBlock);
+    }
+
+    void Engine::buildStages(const AudioChannelSet& layout, double sampleRate, int samplesPerBlock) {
+        // hot stage objects first, next to each other, then their buffers
+        arena.beginSection("Pre");
+        preProcessor = arena.create<PreProcessor>(parameters, layout);
+        arena.beginSection("Fx");
+        fxProcessor = arena.create<FxProcessor>(parameters, layout);
+        arena.beginSection("Mixer");
+        mixerProcessor = arena.create<MixerProcessor>(parameters, arena, layout);
+        arena.beginSection("Spectral");
+        spectralProcessor = arena.create<SpectralProcessor>(parameters, layout);
+        arena.beginSection("Folder");
+        stageFolder = arena.create<StageFolder>(arena, layout);
+
+        arena.beginSection("Pre");
+        preProcessor->prepare(arena, sampleRate, samplesPerBlock);
+        arena.beginSection("Fx");
+        fxProcessor->prepare(arena, sampleRate, samplesPerBlock);
+        arena.beginSection("Mixer");
+        mixerProcessor->prepare(arena, sampleRate, samplesPerBlock);
+        arena.beginSection("Spectral");
+        spectralProcessor->prepare(arena, sampleRate, samplesPerBlock);
+        arena.beginSection("Folder");
+        stageFolder->prepare(arena, sampleRate, samplesPerBlock);
+
+        arena.beginSection("Bypass");
+        dry = arena.take<float*>((size_t)numChannels);
+        dryDelays = arena.take<float*>((size_t)numChannels);
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            dry[ch] = arena.take<float>((size_t)samplesPerBlock);
+            dryDelays[ch] = arena.take<float>(SpectralShaper::fftSize);
+        }
+
+        fadeGains = arena.take<float>((size_t)samplesPerBlock);
+        dryDelayPosition = 0;
+    }
+
+    void Engine::warmUp(int samplesPerBlock) {
+        AudioBuffer<float> silence(numChannels, samplesPerBlock);
+
+        // through both Fx slots and the bypass rings, whatever the parameters
+        // say now, so none of their code or memory is cold when it's first used;
+        // prepare() sets the real latency afterwards
+        latencyInSamples = spectralProcessor->getLatencyInSamples();
+
+        for (int block = 0; block < warmUpBlocks; ++block) {
+            for (auto isSpectral : {false, true}) {
+                silence.clear();
+                processStages(silence, isSpectral);
+            }
+
+            updateDry(silence);
+        }
+    }
+
+    void Engine::release() {
+        if (preProcessor != nullptr) {
+            events.push(Event::Type::release);
+        }
+
+        preProcessor = nullptr;
+        fxProcessor = nullptr;
+        mixerProcessor = nullptr;
+        spectralProcessor = nullptr;
+        stageFolder = nullptr;
+
+        dry = dryDelays = nullptr;
+        fadeGains = nullptr;
+
+        arena.release();
+    }
+
+    void Engine::reset() noexcept {
+        if (preProcessor != nullptr) {
+            events.push(Event::Type::reset);
+            resetStages();
+            clearDryDelays();
+            wetGain.setCurrentAndTargetValue(wetGain.getTargetValue());
+            refillSamples = 0;
+            needsRefill = false;
+        }
+    }
+
+    void Engine::process(AudioBuffer<float>& buffer, bool forceBypass) noexcept {
+        // hosts do send empty blocks; nothing should move on for them, smoothers included
+        if (preProcessor == nullptr || buffer.getNumSamples() == 0) {
+            return;
+        }
+
+        const auto startTicks = Time::getHighResolutionTicks();
+
+        processBlock(buffer, forceBypass);
+
+        // a new level applies from the next block on
+        if (governor.update(Time::getHighResolutionTicks() - startTicks, buffer.getNumSamples())) {
+            const auto quality = governor.getQuality();
+
+            applyQuality(quality);
+            events.push(Event::Type::qualityChange, (int)quality);
+        }
+    }
+
+    void Engine::processBlock(AudioBuffer<float>& buffer, bool forceBypass) noexcept {
+        events.beginBlock(buffer.getNumSamples());
+
+        // the spectral stage takes the fx slot; whichever comes back in starts clean
+        const auto isSpectral = parameters.get(ParameterId::spectralMode) > 0.5f;
+
+        if (isSpectral != wasSpectral) {
+            if (isSpectral) {
+                spectralProcessor->reset();
+            } else {
+                fxProcessor->reset();
+            }
+
+            latencyInSamples = isSpectral ? spectralProcessor->getLatencyInSamples() : 0;
+            wasSpectral = isSpectral;
+            clearDryDelays();
+
+            events.push(Event::Type::fxSwitch, isSpectral ? 1 : 0);
+        }
+
+        const auto isBypassed = forceBypass || parameters.get(ParameterId::bypass) > 0.5f;
+
+        // flushed stages are silent for their latency, and the Fx delay for as
+        // long as it reaches back, so they refill behind the dry signal before
+        // fading back in
+        if (! isBypassed && needsRefill) {
+            refillSamples = jmax(latencyInSamples, isSpectral ? 0 : fxMemoryInSamples);
+            needsRefill = false;
+        }
+
+        const auto isRefilling = ! isBypassed && refillSamples > 0;
+        const auto wetTarget = isBypassed || isRefilling ? 0.f : 1.f;
+
+        if (wetTarget != wetGain.getTargetValue()) {
+            events.push(wetTarget > 0.f ? Event::Type::bypassOff : Event::Type::bypassOn);
+        }
+
+        wetGain.setTargetValue(wetTarget);
+
+        // with latency the rings have to follow the input all the time, not just
+        // while fading, or the dry signal would jump when bypass starts
+        if (latencyInSamples > 0 || wetGain.isSmoothing() || isRefilling) {
+            updateDry(buffer);
+        }
+
+        if (! wetGain.isSmoothing()) {
+            if (! isBypassed && ! isRefilling) {
+                isFullyBypassed = false;
+                processStages(buffer, isSpectral);
+                return;
+            }
+
+            if (isRefilling) {
+                isFullyBypassed = false;
+                processStages(buffer, isSpectral);
+                refillSamples -= buffer.getNumSamples();
+            } else if (! isFullyBypassed) {
+                isFullyBypassed = true;
+
+                // NOTE: bypassState 0 = freeze, 1 = flush.
+                if (parameters.get(ParameterId::bypassState) > 0.5f) {
+                    events.push(Event::Type::flush);
+                    resetStages();
+                    needsRefill = true;
+                }
+            }
+
+            if (latencyInSamples > 0 || isRefilling) {
+                for (int ch = 0; ch < numChannels; ++ch) {
+                    FloatVectorOperations::copy(buffer.getWritePointer(ch), dry[ch], buffer.getNumSamples());
+                }
+            }
+
+            return;
+        }
+
+        isFullyBypassed = false;
+        processStages(buffer, isSpectral);
+
+        // equal-gain crossfade, the two sides are mostly correlated
+        const auto numSamples = buffer.getNumSamples();
+
+        for (int i = 0; i < numSamples; ++i) {
+            fadeGains[i] = wetGain.getNextValue();
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            auto* samples = buffer.getWritePointer(ch);
+            const auto* drySamples = dry[ch];
+
+            for (int i = 0; i < numSamples; ++i) {
+                samples[i] = drySamples[i] + fadeGains[i] * (samples[i] - drySamples[i]);
+            }
+        }
+    }
+
+    //==============================================================================
+    void Engine::processStages(AudioBuffer<float>& buffer, bool isSpectral) noexcept {
+        const auto processFx = [this, isSpectral](AudioBuffer<float>& b) {
+            if (isSpectral) {
+                spectralProcessor->process(b);
+            } else {
+                fxProcessor->process(b);
+            }
+        };
+
+        // NOTE: fxPosition > 0.5 = fx before the mixer, else after it.
+        const auto isFxFirst = parameters.get(ParameterId::fxPosition) > 0.5f;
+
+        preProcessor->updateParameter();
+        mixerProcessor->updateParameter();
+
+        // settled Pre and mixer gains run as one folded matrix
+        if (stageFolder->update(*preProcessor, *mixerProcessor, isSpectral && isFxFirst)) {
+            if (isFxFirst) {
+                processFx(buffer);
+                stageFolder->process(buffer);
+            } else {
+                stageFolder->process(buffer);
+                processFx(buffer);
+            }
+
+            return;
+        }
+
+        preProcessor->process(buffer);
+
+        if (isFxFirst) {
+            processFx(buffer);
+            mixerProcessor->process(buffer);
+        } else {
+            mixerProcessor->process(buffer);
+            processFx(buffer);
+        }
+    }
+
+    void Engine::computeResponse(const Parameters& parameters, const CoefficientTables& tables, ResponseGrid& grid) noexcept {
+        const auto isSpectral = parameters.get(ParameterId::spectralMode) > 0.5f;
+        const auto isFxFirst = parameters.get(ParameterId::fxPosition) > 0.5f;
+
+        const auto applyFx = [&] {
+            if (isSpectral) {
+                SpectralProcessor::applyResponse(parameters, tables, grid);
+            } else {
+                FxProcessor::applyResponse(parameters, tables, grid);
+            }
+        };
+
+        PreProcessor::applyResponse(parameters, tables, grid);
+
+        if (isFxFirst) {
+            applyFx();
+            MixerProcessor::applyResponse(parameters, tables, grid);
+        } else {
+            MixerProcessor::applyResponse(parameters, tables, grid);
+            applyFx();
+        }
+    }
+
+    void Engine::applyQuality(Quality quality) noexcept {
+        fxProcessor->setQuality(quality);
+        spectralProcessor->setQuality(quality);
+        stageFolder->setQuality(quality);
+    }
+
+    void Engine::resetStages() noexcept {
+        preProcessor->reset();
+        fxProcessor->reset();
+        mixerProcessor->reset();
+        spectralProcessor->reset();
+    }
+
+    void Engine::updateDry(const AudioBuffer<float>& buffer) noexcept {
+        const auto numSamples = buffer.getNumSamples();
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            FloatVectorOperations::copy(dry[ch], buffer.getReadPointer(ch), numSamples);
+        }
+
+        if (latencyInSamples == 0) {
+            return;
+        }
+
+        // rings of exactly the latency, as in SpectralProcessor
+        jassert(latencyInSamples == SpectralShaper::fftSize);
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            auto* samples = dry[ch];
+            auto* ring = dryDelays[ch];
+            auto position = dryDelayPosition;
+
+            for (int n = 0; n < numSamples; ++n) {
+                std::swap(samples[n], ring[position]);
+                position = (position + 1) & (SpectralShaper::fftSize - 1);
+            }
+        }
+
+        dryDelayPosition = (dryDelayPosition + numSamples) & (SpectralShaper::fftSize - 1);
+    }
+
+    void Engine::clearDryDelays() noexcept {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            FloatVectorOperations::clear(dryDelays[ch], SpectralShaper::fftSize);
+        }
+
+        dryDelayPosition = 0;
+    }
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+#include "Arena.h"
+#include "EventLog.h"
+#include "LoadGovernor.h"
+#include "Parameters.h"
+
+namespace process {
+    class CoefficientTables;
+    class ResponseGrid;
+    class PreProcessor;
+    class FxProcessor;
+    class MixerProcessor;
+    class SpectralProcessor;
+    class StageFolder;
+
+    //==============================================================================
+    // The whole shaping chain, Pre -> Fx/mixer in fxPosition order, with the
+    // spectral stage in the Fx slot when it's on, and the folded fast path. Owns
+    // the arena; needs nothing beyond the DSP modules, so the plugin and the C
+    // API in PantheonDsp.h both run it.
+    //
+    // Bypass crossfades to the dry signal, delayed by the chain's latency. Once
+    // fully bypassed no stage runs, and their state is kept or cleared as the
+    // bypassState parameter says.
+    //
+    // With adaptive quality on, every block is timed against its realtime
+    // budget and a LoadGovernor moves the stages to cheaper modes under
+    // sustained load, and back when it eases; see Quality for what each level
+    // gives up.
+    class Engine {
+    public:
+        explicit Engine(const Parameters&);
+        ~Engine();
+
+        // allocates, not realtime safe; see setWarmUp() for what else it does
+        void prepare(const AudioChannelSet&, double sampleRate, int samplesPerBlock);
+        void release();
+        void reset() noexcept;
+
+        // no more than samplesPerBlock at a time; forceBypass for hosts that
+        // bypass without going through the bypass parameter
+        void process(AudioBuffer<float>&, bool forceBypass = false) noexcept;
+
+        bool isPrepared() const noexcept { return preProcessor != nullptr; }
+
+        // of the Fx stage in use, as of the last prepare() or process()
+        int getLatencyInSamples() const noexcept { return latencyInSamples; }
+
+        //==============================================================================
+        // off by default; leave it off for offline rendering, where there's no deadline
+        void setAdaptiveQuality(bool shouldAdapt) noexcept { governor.setEnabled(shouldAdapt); }
+
+        // readable from any thread
+        Quality getQuality() const noexcept { return governor.getQuality(); }
+        int getNumQualityTransitions() const noexcept { return governor.getNumTransitions(); }
+        float getLoad() const noexcept { return governor.getLoad(); }
+
+        //==============================================================================
+        // on by default: prepare() runs warmUpBlocks of silence through every
+        // stage and then builds them afresh, so the first blocks after it cost
+        // what later ones do; the output is the same either way
+        void setWarmUp(bool shouldWarmUp) noexcept { warmsUp = shouldWarmUp; }
+
+        // off by default: prepare() also locks the stages' memory into RAM,
+        // where the OS allows it
+        void setLockMemory(bool shouldLock) noexcept { locksMemory = shouldLock; }
+        bool isMemoryLocked() const noexcept { return arena.isLocked(); }
+
+        static constexpr int warmUpBlocks = 4;
+
+        //==============================================================================
+        std::vector<Arena::Section> getMemoryFootprint() const { return arena.getSections(); }
+        size_t getMemoryFootprintInBytes() const noexcept { return arena.getCapacity(); }
+
+        //==============================================================================
+        // the front pair's response to a mono input, in the order process() runs
+        // the stages, for what the chain settles to with these parameters; bypass
+        // and the spectral latency are left out. Needs no prepared engine.
+        static void computeResponse(const Parameters&, const CoefficientTables&, ResponseGrid&) noexcept;
+
+        //==============================================================================
+        static constexpr double bypassFadeMilliseconds { 10. };
+
+    private:
+        //==============================================================================
+        void buildStages(const AudioChannelSet&, double sampleRate, int samplesPerBlock);
+        void warmUp(int samplesPerBlock);
+
+        void processBlock(AudioBuffer<float>&, bool forceBypass) noexcept;
+        void processStages(AudioBuffer<float>&, bool isSpectral) noexcept;
+        void applyQuality(Quality) noexcept;
+        void resetStages() noexcept;
+
+        // the input, delayed by the current latency, into dry
+        void updateDry(const AudioBuffer<float>&) noexcept;
+        void clearDryDelays() noexcept;
+
+        //==============================================================================
+        const Parameters& parameters;
+
+        // every stage and its buffers live in one block, rebuilt by prepare()
+        Arena arena;
+        bool warmsUp { true };
+        bool locksMemory { false };
+
+        PreProcessor* preProcessor { nullptr };
+        FxProcessor* fxProcessor { nullptr };
+        MixerProcessor* mixerProcessor { nullptr };
+        SpectralProcessor* spectralProcessor { nullptr };
+        StageFolder* stageFolder { nullptr };
+
+        bool wasSpectral { false };
+        int latencyInSamples { 0 };
+
+        LoadGovernor governor;
+
+        //==============================================================================
+        LinearSmoothedValue<float> wetGain;
+        bool isFullyBypassed { false };
+        bool needsRefill { false };
+        int refillSamples { 0 };
+
+        // how far back the Fx stage reaches, its delay ring at the longest
+        int fxMemoryInSamples { 0 };
+
+        int numChannels { 0 };
+        float** dry { nullptr };
+        float** dryDelays { nullptr };
+        int dryDelayPosition { 0 };
+        float* fadeGains { nullptr };
+
+        //==============================================================================
+        // prepares, resets, mode switches, bypass and parameter jumps, as they
+        // happen; nothing at all unless PANTHEON_EVENT_LOG is on
+        EventLog events { parameters };
+
+        //==============================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Engine)
+    };
+}
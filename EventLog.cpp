@@ -0,0 +1,194 @@
+#include "EventLog.h"
+#include <cmath>
+#include <iostream>
+
+#if PANTHEON_EVENT_LOG
+
+namespace process {
+    //==============================================================================
+    static const char* getTypeName(Event::Type type) noexcept {
+        switch (type) {
+            case Event::Type::prepare:          return "prepare";
+            case Event::Type::release:          return "release";
+            case Event::Type::reset:            return "reset";
+            case Event::Type::fxSwitch:         return "fxSwitch";
+            case Event::Type::bypassOn:         return "bypassOn";
+            case Event::Type::bypassOff:        return "bypassOff";
+            case Event::Type::flush:            return "flush";
+            case Event::Type::parameterJump:    return "parameterJump";
+            case Event::Type::qualityChange:    return "qualityChange";
+        }
+
+        return "unknown";
+    }
+
+    //==============================================================================
+    EventLogWriter::EventLogWriter()
+        : Thread("Pantheon event log")
+        , startTicks(Time::getHighResolutionTicks())
+    {
+        const auto output = SystemStats::getEnvironmentVariable("PANTHEON_EVENT_LOG_OUTPUT", {}).trim();
+
+        isConsole = output.equalsIgnoreCase("console");
+
+        if (! isConsole) {
+            file = output.isNotEmpty() ? File::getCurrentWorkingDirectory().getChildFile(output)
+                                       : File::getSpecialLocation(File::tempDirectory).getChildFile("Pantheon").getChildFile("events.log");
+            file.getParentDirectory().createDirectory();
+        }
+
+        write("# started " + Time::getCurrentTime().toISO8601(true)
+              + ": seconds, log, event, detail, sample position, parameters");
+
+        startThread();
+    }
+
+    EventLogWriter::~EventLogWriter() {
+        stopThread(1000);
+    }
+
+    void EventLogWriter::add(EventLog* log) {
+        const ScopedLock sl(lock);
+        logs.addIfNotAlreadyThere(log);
+    }
+
+    void EventLogWriter::remove(EventLog* log) {
+        const ScopedLock sl(lock);
+        drain(*log);
+        logs.removeFirstMatchingValue(log);
+    }
+
+    void EventLogWriter::run() {
+        while (! threadShouldExit()) {
+            {
+                const ScopedLock sl(lock);
+
+                for (auto* log : logs) {
+                    drain(*log);
+                }
+            }
+
+            wait(100);
+        }
+    }
+
+    void EventLogWriter::drain(EventLog& log) {
+        if (const auto numDropped = log.takeNumDropped()) {
+            write("# log " + String(log.getId()) + " dropped " + String(numDropped) + " events, the ring was full");
+        }
+
+        Event event;
+
+        while (log.pop(event)) {
+            String line;
+            line << String(Time::highResolutionTicksToSeconds(event.ticks - startTicks), 6)
+                 << ", " << log.getId()
+                 << ", " << getTypeName(event.type)
+                 << ", " << (event.type == Event::Type::parameterJump ? String(Parameters::getInfo((ParameterId)event.detail).id)
+                                                                      : String(event.detail))
+                 << ", " << event.samplePosition
+                 << ",";
+
+            for (int i = 0; i < Parameters::numParameters; ++i) {
+                line << " " << Parameters::getInfo((ParameterId)i).id << "=" << event.values[i];
+            }
+
+            write(line);
+        }
+    }
+
+    void EventLogWriter::write(const String& line) {
+        if (isConsole) {
+            std::cout << line << std::endl;
+            return;
+        }
+
+        if (stream != nullptr && stream->getPosition() > maxFileBytes) {
+            stream = nullptr;
+            file.moveFileTo(file.getSiblingFile(file.getFileNameWithoutExtension() + ".1" + file.getFileExtension()));
+        }
+
+        if (stream == nullptr) {
+            stream = file.createOutputStream();
+
+            if (stream == nullptr) {
+                return;
+            }
+        }
+
+        stream->writeText(line + "\n", false, false, nullptr);
+        stream->flush();
+    }
+
+    //==============================================================================
+    static std::atomic<int> nextLogId { 0 };
+
+    EventLog::EventLog(const Parameters& values)
+        : parameters(values)
+        , events((size_t)capacity)
+        , id(++nextLogId)
+    {
+        for (int i = 0; i < Parameters::numParameters; ++i) {
+            lastValues[i] = parameters.get((ParameterId)i);
+        }
+
+        writer->add(this);
+    }
+
+    EventLog::~EventLog() {
+        writer->remove(this);
+    }
+
+    void EventLog::restart() noexcept {
+        blockPosition = nextPosition = 0;
+    }
+
+    void EventLog::beginBlock(int numSamples) noexcept {
+        blockPosition = nextPosition;
+        nextPosition += numSamples;
+
+        for (int i = 0; i < Parameters::numParameters; ++i) {
+            const auto parameterId = (ParameterId)i;
+            const auto& info = Parameters::getInfo(parameterId);
+            const auto value = parameters.get(parameterId);
+
+            if (std::abs(value - lastValues[i]) > jumpThreshold * (info.maximum - info.minimum)) {
+                push(Event::Type::parameterJump, i);
+            }
+
+            lastValues[i] = value;
+        }
+    }
+
+    void EventLog::push(Event::Type type, int detail) noexcept {
+        const auto scope = fifo.write(1);
+
+        if (scope.blockSize1 == 0) {
+            dropped.fetch_add(1);
+            return;
+        }
+
+        auto& event = events[scope.startIndex1];
+        event.type = type;
+        event.detail = detail;
+        event.samplePosition = blockPosition;
+        event.ticks = Time::getHighResolutionTicks();
+
+        for (int i = 0; i < Parameters::numParameters; ++i) {
+            event.values[i] = parameters.get((ParameterId)i);
+        }
+    }
+
+    bool EventLog::pop(Event& event) noexcept {
+        const auto scope = fifo.read(1);
+
+        if (scope.blockSize1 == 0) {
+            return false;
+        }
+
+        event = events[scope.startIndex1];
+        return true;
+    }
+}
+
+#endif
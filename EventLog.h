@@ -0,0 +1,136 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+
+#include "Parameters.h"
+
+// On by default in debug builds, see CMakeLists.txt. At 0 the log below is an
+// empty class and every call on it compiles to nothing.
+#ifndef PANTHEON_EVENT_LOG
+ #define PANTHEON_EVENT_LOG 0
+#endif
+
+namespace process {
+    //==============================================================================
+    struct Event {
+        enum class Type {
+            prepare = 0,
+            release,
+            reset,
+            fxSwitch,       // detail: 1 to the spectral stage, 0 back to the Fx stages
+            bypassOn,       // the fade to dry starts
+            bypassOff,      // the fade back to the chain starts
+            flush,
+            parameterJump,  // detail: the ParameterId
+            qualityChange,  // detail: the new Quality
+        };
+
+        Type type;
+        int detail;
+        int64 samplePosition;   // of the block, counted from prepare
+        int64 ticks;            // Time::getHighResolutionTicks()
+        float values[Parameters::numParameters];
+    };
+
+   #if PANTHEON_EVENT_LOG
+    class EventLog;
+
+    //==============================================================================
+    // One thread per process that drains every live EventLog a few times a
+    // second. PANTHEON_EVENT_LOG_OUTPUT picks where to: "console" for stdout,
+    // a file path, or by default Pantheon/events.log in the temp directory. A
+    // file is rotated to <name>.1.log once it passes maxFileBytes.
+    class EventLogWriter : private Thread {
+    public:
+        static constexpr int64 maxFileBytes = 4 << 20;
+
+        EventLogWriter();
+        ~EventLogWriter() override;
+
+        void add(EventLog*);
+
+        // writes out what's left in the log first
+        void remove(EventLog*);
+
+    private:
+        //==============================================================================
+        void run() override;
+
+        void drain(EventLog&);
+        void write(const String& line);
+
+        //==============================================================================
+        CriticalSection lock;
+        Array<EventLog*> logs;
+
+        bool isConsole { false };
+        File file;
+        std::unique_ptr<FileOutputStream> stream;
+        const int64 startTicks;
+
+        //==============================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EventLogWriter)
+    };
+
+    //==============================================================================
+    // A fixed ring of events with a single writer, the thread driving the engine.
+    // push() copies into a slot allocated up front, through an AbstractFifo: no
+    // allocation and no lock. When the ring is full the event is only counted,
+    // and the writer reports the gap.
+    class EventLog {
+    public:
+        static constexpr int capacity = 1024;
+
+        // a change of more than this much of a parameter's range between two blocks
+        static constexpr float jumpThreshold = 0.25f;
+
+        explicit EventLog(const Parameters&);
+        ~EventLog();
+
+        // the position starts over from 0
+        void restart() noexcept;
+
+        // at the start of every block: logs parameter jumps and moves the position on
+        void beginBlock(int numSamples) noexcept;
+
+        void push(Event::Type, int detail = 0) noexcept;
+
+        //==============================================================================
+        // for EventLogWriter
+        int getId() const noexcept { return id; }
+        bool pop(Event&) noexcept;
+        int64 takeNumDropped() noexcept { return dropped.exchange(0); }
+
+    private:
+        //==============================================================================
+        const Parameters& parameters;
+
+        AbstractFifo fifo { capacity };
+        HeapBlock<Event> events;
+        std::atomic<int64> dropped { 0 };
+
+        float lastValues[Parameters::numParameters] {};
+        int64 blockPosition { 0 };
+        int64 nextPosition { 0 };
+
+        const int id;
+
+        SharedResourcePointer<EventLogWriter> writer;
+
+        //==============================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EventLog)
+    };
+   #else
+    //==============================================================================
+    class EventLog {
+    public:
+        explicit EventLog(const Parameters&) noexcept {}
+
+        void restart() noexcept {}
+        void beginBlock(int) noexcept {}
+        void push(Event::Type, int = 0) noexcept {}
+    };
+   #endif
+}
@@ -1,9 +1,10 @@
 #include "FxComponent.h"
 
+#include "Processors.h"
+
 FxComponent::FxComponent(AudioPluginAudioProcessor& p, AudioProcessorValueTreeState& apvts)
     : processorRef(p)
     , parameters(apvts)
-    , panLook(PanLook::Origin::FromMid)
     , delayLineSlider(Slider::RotaryHorizontalVerticalDrag, Slider::NoTextBox)
     , allPassFreqSlider(Slider::RotaryHorizontalVerticalDrag, Slider::NoTextBox)
 {
@@ -13,7 +14,7 @@ FxComponent::FxComponent(AudioPluginAudioProcessor& p, AudioProcessorValueTreeSt
         postFxButton.setToggleState(true, sendNotification);
     }
 
-    preFxButton.setLookAndFeel(&panLook);
+    preFxButton.setLookAndFeel(&looks->fromMid);
     preFxButton.setClickingTogglesState(true);
     preFxButton.setButtonText("Pre");
     preFxButton.setConnectedEdges(TextButton::ConnectedOnRight);
@@ -21,7 +22,7 @@ FxComponent::FxComponent(AudioPluginAudioProcessor& p, AudioProcessorValueTreeSt
     preFxButton.onClick = [this](){fxPositionToggleUpdate(true);};
     addAndMakeVisible(preFxButton);
 
-    postFxButton.setLookAndFeel(&panLook);
+    postFxButton.setLookAndFeel(&looks->fromMid);
     postFxButton.setClickingTogglesState(true);
     postFxButton.setButtonText("Post");
     postFxButton.setConnectedEdges(TextButton::ConnectedOnLeft);
@@ -29,11 +30,21 @@ FxComponent::FxComponent(AudioPluginAudioProcessor& p, AudioProcessorValueTreeSt
     postFxButton.onClick = [this](){fxPositionToggleUpdate(false);};
     addAndMakeVisible(postFxButton);
 
-    delayLineSlider.setLookAndFeel(&panLook);
+    alignButton.setLookAndFeel(&looks->fromMid);
+    alignButton.setButtonText("Align");
+    alignButton.setTooltip("Listen to the input and set the delay to line left and right up");
+    alignButton.onClick = [this](){alignClicked();};
+    addAndMakeVisible(alignButton);
+
+    alignLabel.setJustificationType(Justification::centred);
+    alignLabel.setColour(Label::textColourId, Colours::linen);
+    addAndMakeVisible(alignLabel);
+
+    delayLineSlider.setLookAndFeel(&looks->fromMid);
     addAndMakeVisible(delayLineSlider);
     delayLineAttachment.reset(new SliderAttachment(parameters, "delayLine", delayLineSlider));
 
-    allPassFreqSlider.setLookAndFeel(&panLook);
+    allPassFreqSlider.setLookAndFeel(&looks->fromMid);
     addAndMakeVisible(allPassFreqSlider);
     allPassFreqAttachment.reset(new SliderAttachment(parameters, "allPassFreq", allPassFreqSlider));
 
@@ -48,14 +59,16 @@ FxComponent::FxComponent(AudioPluginAudioProcessor& p, AudioProcessorValueTreeSt
     filterLabel.setEnabled(false);
     addAndMakeVisible(filterLabel);
 
-    border.setLookAndFeel(&panLook);
+    border.setLookAndFeel(&looks->fromMid);
     border.setText("Fx");
     border.setEnabled(false);
     border.setColour(GroupComponent::outlineColourId, Colours::linen);
     addAndMakeVisible(border);
 }
 
-FxComponent::~FxComponent() {}
+FxComponent::~FxComponent() {
+    processorRef.stopAlignment();
+}
 
 void FxComponent::paint(juce::Graphics& g) {
     g.fillAll (getLookAndFeel().findColour (ResizableWindow::backgroundColourId));
@@ -82,8 +95,8 @@ void FxComponent::resized() {
     };
 
     grid.items = {
-        GridItem(),
-        GridItem(),
+        GridItem(alignButton),
+        GridItem(alignLabel),
         GridItem(preFxButton),
         GridItem(postFxButton),
         GridItem(delayLineSlider),
@@ -98,4 +111,45 @@ void FxComponent::resized() {
 
 void FxComponent::fxPositionToggleUpdate(bool val) {
     parameters.getRawParameterValue("fxPosition") -> store(val ? 1.f : 0.f);
-}
\ No newline at end of file
+}
+
+void FxComponent::alignClicked() {
+    if (! processorRef.isAligning()) {
+        processorRef.startAlignment();
+        alignButton.setButtonText("Listening");
+        alignLabel.setText({}, dontSendNotification);
+        startTimerHz(10);
+        return;
+    }
+
+    if (processorRef.getAlignmentEstimate().hasConverged) {
+        processorRef.applyAlignment();
+    } else {
+        processorRef.stopAlignment();
+        alignLabel.setText({}, dontSendNotification);
+    }
+
+    alignButton.setButtonText("Align");
+    stopTimer();
+}
+
+void FxComponent::timerCallback() {
+    const auto estimate = processorRef.getAlignmentEstimate();
+
+    if (estimate.numWindows == 0) {
+        return;
+    }
+
+    // which side gets delayed, and by how much
+    const auto value = processorRef.getAlignmentDelayValue(estimate);
+    const auto milliseconds = std::abs(value) * (float)process::FxProcessor::maxDelayInMilliseconds;
+
+    auto text = String(value < 0.f ? "L " : "R ") + String(milliseconds, 2) + " ms";
+
+    if (estimate.isInverted) {
+        text << ", inverted";
+    }
+
+    alignLabel.setText(text, dontSendNotification);
+    alignButton.setButtonText(estimate.hasConverged ? "Apply" : "Listening");
+}
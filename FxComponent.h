@@ -7,7 +7,7 @@
 
 #include "LookAndFeel.h"
 
-class FxComponent : public juce::Component
+class FxComponent : public juce::Component, private Timer
 {
 public:
     FxComponent(AudioPluginAudioProcessor&, AudioProcessorValueTreeState&);
@@ -23,12 +23,14 @@ private:
 
     static constexpr int fxPositionRadioButtonId = 777;
 
-    PanLook panLook;
+    SharedResourcePointer<PanLooks> looks;
 
     Label delayLabel;
     Label filterLabel;
     TextButton preFxButton;
     TextButton postFxButton;
+    TextButton alignButton;
+    Label alignLabel;
     Slider delayLineSlider;
     Slider allPassFreqSlider;
 
@@ -39,5 +41,9 @@ private:
 
     void fxPositionToggleUpdate(bool);
 
+    // Align listens, then offers Apply once the estimate has settled
+    void alignClicked();
+    void timerCallback() override;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FxComponent)
 };
@@ -0,0 +1,134 @@
+#include "FxStages.h"
+
+namespace process {
+    //==============================================================================
+    size_t DelayStage::getArenaBytes(double sampleRate, int samplesPerBlock) noexcept {
+        return StereoDelay::getArenaBytes(sampleRate, maxDelayInMilliseconds)
+             + 2 * Arena::sizeFor<float>((size_t)samplesPerBlock);
+    }
+
+    void DelayStage::prepare(Arena& arena, const CoefficientTables&, double sampleRate, int samplesPerBlock) {
+        smoothedDelay.reset(sampleRate, smoothingSeconds);
+        integerBlend.reset(samplesPerBlock / 8);
+        delayLine.prepare(arena, sampleRate, maxDelayInMilliseconds);
+
+        leftDelays = arena.take<float>((size_t)samplesPerBlock);
+        rightDelays = arena.take<float>((size_t)samplesPerBlock);
+    }
+
+    void DelayStage::update(const Parameters& parameters) noexcept {
+        smoothedDelay.setTargetValue(parameters.get(ParameterId::delayLine));
+        blend = integerBlend.getNextValue();
+
+        delayLine.setInterpolation((StereoDelay::Interpolation)(int)parameters.get(ParameterId::delayInterpolation));
+
+        if (! smoothedDelay.isSmoothing()) {
+            float left, right;
+            getDelays(smoothedDelay.getCurrentValue(), left, right);
+
+            delayLine.setDelay(0, left);
+            delayLine.setDelay(1, right);
+        }
+    }
+
+    void DelayStage::getDelays(float value, float& left, float& right) const noexcept {
+        const auto maxDelayInSamples = delayLine.getMaximumDelayInSamples();
+
+        left = std::abs(jlimit(-1.f, 0.f, value)) * maxDelayInSamples;
+        right = jlimit(0.f, 1.f, value) * maxDelayInSamples;
+
+        if (blend > 0.f) {
+            const auto roundedLeft = std::round(left);
+            const auto roundedRight = std::round(right);
+
+            left = blend >= 1.f ? roundedLeft : left + blend * (roundedLeft - left);
+            right = blend >= 1.f ? roundedRight : right + blend * (roundedRight - right);
+        }
+    }
+
+    void DelayStage::setQuality(Quality quality) noexcept {
+        integerBlend.setTargetValue(quality == Quality::Full ? 0.f : 1.f);
+    }
+
+    void DelayStage::process(float* left, float* right, int numSamples) noexcept {
+        if (numSamples <= 0) {
+            return;
+        }
+
+        if (! smoothedDelay.isSmoothing()) {
+            delayLine.process(left, right, numSamples);
+            return;
+        }
+
+        // a glide moves the read taps every sample, not once per block
+        for (int i = 0; i < numSamples; ++i) {
+            getDelays(smoothedDelay.getNextValue(), leftDelays[i], rightDelays[i]);
+        }
+
+        delayLine.process(left, right, leftDelays, rightDelays, numSamples);
+
+        // where the glide got to, for the blocks after it ends
+        delayLine.setDelay(0, leftDelays[numSamples - 1]);
+        delayLine.setDelay(1, rightDelays[numSamples - 1]);
+    }
+
+    void DelayStage::reset() noexcept {
+        delayLine.reset();
+    }
+
+    void DelayStage::applyResponse(const Parameters& parameters, const CoefficientTables& tables, ResponseGrid& grid) noexcept {
+        const auto value = parameters.get(ParameterId::delayLine);
+        const auto interpolation = (StereoDelay::Interpolation)(int)parameters.get(ParameterId::delayInterpolation);
+        const auto maxDelayInSamples = (float)StereoDelay::getMaximumDelay(tables.getSampleRate(), maxDelayInMilliseconds);
+
+        StereoDelay::applyResponse(grid, 0, std::abs(jlimit(-1.f, 0.f, value)) * maxDelayInSamples, interpolation);
+        StereoDelay::applyResponse(grid, 1, jlimit(0.f, 1.f, value) * maxDelayInSamples, interpolation);
+    }
+
+    //==============================================================================
+    size_t AllPassStage::getArenaBytes(double, int) noexcept {
+        return 0;
+    }
+
+    void AllPassStage::prepare(Arena&, const CoefficientTables& tables, double, int samplesPerBlock) {
+        smoothedFilter.reset(samplesPerBlock / 8);
+        allPassBank.prepare(tables);
+    }
+
+    void AllPassStage::update(const Parameters& parameters) noexcept {
+        smoothedFilter.setTargetValue(parameters.get(ParameterId::allPassFreq));
+
+        const auto value = smoothedFilter.getNextValue();
+        const auto spread = parameters.get(ParameterId::allPassSpread);
+
+        allPassBank.setNumStages((int)parameters.get(ParameterId::allPassStages));
+        allPassBank.setCutoffPosition(0, 1.f - std::abs(jlimit(-1.f, 0.f, value)), spread);
+        allPassBank.setCutoffPosition(1, 1.f - jlimit(0.f, 1.f, value), spread);
+    }
+
+    void AllPassStage::process(float* left, float* right, int numSamples) noexcept {
+        allPassBank.process(left, right, numSamples);
+    }
+
+    void AllPassStage::reset() noexcept {
+        allPassBank.reset();
+    }
+
+    void AllPassStage::applyResponse(const Parameters& parameters, const CoefficientTables& tables, ResponseGrid& grid) noexcept {
+        const auto value = parameters.get(ParameterId::allPassFreq);
+        const auto spread = parameters.get(ParameterId::allPassSpread);
+        const auto numStages = jlimit(AllPassBank::minStages, AllPassBank::maxStages, (int)parameters.get(ParameterId::allPassStages));
+
+        const float positions[2] {
+            1.f - std::abs(jlimit(-1.f, 0.f, value)),
+            1.f - jlimit(0.f, 1.f, value),
+        };
+
+        for (int ch = 0; ch < 2; ++ch) {
+            for (int stage = 0; stage < numStages; ++stage) {
+                const auto a = AllPassBank::getCoefficient(tables, positions[ch], spread, stage, numStages);
+                grid.multiplyFirstOrder(ch, a, 1.f, a);
+            }
+        }
+    }
+}
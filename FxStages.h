@@ -0,0 +1,249 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <tuple>
+#include <utility>
+
+#include "AllPassBank.h"
+#include "Arena.h"
+#include "Coefficients.h"
+#include "LoadGovernor.h"
+#include "Parameters.h"
+#include "ResponseGrid.h"
+#include "StereoDelay.h"
+
+namespace process {
+    //==============================================================================
+    // What a stage declares about each of its parameters. The DSP-side parameter
+    // table and the plugin's parameter layout are both built from these.
+    struct StageParameter {
+        enum Kind {
+            Float = 0,
+            Int,
+            Bool,
+            Choice,
+        };
+
+        ParameterId index;
+        const char* id;
+        const char* name;
+        float minimum;
+        float maximum;
+        float defaultValue;
+        float interval;
+        Kind kind;
+
+        // Choice only: the names of 0 to maximum, separated by '|'
+        const char* choices { nullptr };
+    };
+
+    //==============================================================================
+    // A stereo Fx stage is a plain class with:
+    //  - static constexpr StageParameter enable, its on/off switch
+    //  - static constexpr StageParameter parameters[]
+    //  - static size_t getArenaBytes(double sampleRate, int samplesPerBlock)
+    //  - prepare(Arena&, const CoefficientTables&, sampleRate, samplesPerBlock)
+    //  - update(const Parameters&), once per block before process()
+    //  - process(float* left, float* right, int numSamples), in place
+    //  - reset()
+    //  - setQuality(Quality), the governor's level; empty if there's no cheaper mode
+    //  - static applyResponse(const Parameters&, const CoefficientTables&, ResponseGrid&),
+    //    multiplying in what the stage settles to for these parameters
+    class DelayStage {
+    public:
+        static constexpr double maxDelayInMilliseconds { 20. };
+
+        static constexpr StageParameter enable {
+            ParameterId::delayEnabled, "delayEnabled", "Delay On", 0.f, 1.f, 1.f, 1.f, StageParameter::Bool
+        };
+
+        // NOTE: negative delays the left channel, positive the right.
+        static constexpr StageParameter parameters[] {
+            {ParameterId::delayLine, "delayLine", "Delay", -1.f, 1.f, 0.f, 0.f, StageParameter::Float},
+            {ParameterId::delayInterpolation, "delayInterpolation", "Delay Interpolation", 0.f, 2.f, 0.f, 1.f, StageParameter::Choice, "Linear|Lagrange|Thiran"},
+        };
+
+        // how long a change of the delay glides for, sample by sample
+        static constexpr double smoothingSeconds { 0.05 };
+
+        DelayStage() = default;
+
+        static size_t getArenaBytes(double sampleRate, int samplesPerBlock) noexcept;
+
+        void prepare(Arena&, const CoefficientTables&, double sampleRate, int samplesPerBlock);
+        void update(const Parameters&) noexcept;
+        void process(float* left, float* right, int numSamples) noexcept;
+        void reset() noexcept;
+
+        // below Full the delays glide to whole samples, which skips the interpolation
+        void setQuality(Quality) noexcept;
+
+        static void applyResponse(const Parameters&, const CoefficientTables&, ResponseGrid&) noexcept;
+
+    private:
+        // the left and right delays in samples for a delayLine value
+        void getDelays(float value, float& left, float& right) const noexcept;
+
+        StereoDelay delayLine;
+        LinearSmoothedValue<float> smoothedDelay;
+
+        // 0 is the exact delay, 1 rounded to whole samples
+        LinearSmoothedValue<float> integerBlend;
+        float blend { 0.f };
+
+        // per-sample delays while smoothedDelay glides
+        float* leftDelays { nullptr };
+        float* rightDelays { nullptr };
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DelayStage)
+    };
+
+    //==============================================================================
+    class AllPassStage {
+    public:
+        static constexpr StageParameter enable {
+            ParameterId::allPassEnabled, "allPassEnabled", "All-Pass On", 0.f, 1.f, 1.f, 1.f, StageParameter::Bool
+        };
+
+        // NOTE: spread is in octaves, each side of the all-pass frequency.
+        static constexpr StageParameter parameters[] {
+            {ParameterId::allPassFreq, "allPassFreq", "All-Pass Filter", -1.f, 1.f, 0.f, 0.f, StageParameter::Float},
+            {ParameterId::allPassStages, "allPassStages", "All-Pass Stages", (float)AllPassBank::minStages, (float)AllPassBank::maxStages, 2.f, 1.f, StageParameter::Int},
+            {ParameterId::allPassSpread, "allPassSpread", "All-Pass Spread", 0.f, 2.f, 0.f, 0.01f, StageParameter::Float},
+        };
+
+        AllPassStage() = default;
+
+        static size_t getArenaBytes(double sampleRate, int samplesPerBlock) noexcept;
+
+        void prepare(Arena&, const CoefficientTables&, double sampleRate, int samplesPerBlock);
+        void update(const Parameters&) noexcept;
+        void process(float* left, float* right, int numSamples) noexcept;
+        void reset() noexcept;
+
+        void setQuality(Quality) noexcept {}
+
+        static void applyResponse(const Parameters&, const CoefficientTables&, ResponseGrid&) noexcept;
+
+    private:
+        AllPassBank allPassBank;
+        LinearSmoothedValue<float> smoothedFilter;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AllPassStage)
+    };
+
+    //==============================================================================
+    // The stages, in processing order, composed at compile time: no graph, no
+    // virtual calls, every stage's process() inlined into one call sequence. A
+    // disabled stage costs one parameter read and comes back in clean.
+    template <typename... Stages>
+    class FxChain {
+    public:
+        static constexpr int numStages = (int)sizeof...(Stages);
+
+        // blocks between update() calls below Quality::Full
+        static constexpr int reducedControlInterval = 4;
+
+        FxChain() = default;
+
+        // fn(const StageParameter&) for every enable flag and parameter, in order
+        template <typename Function>
+        static void forEachParameter(Function&& fn) {
+            (forEachParameterOf<Stages>(fn), ...);
+        }
+
+        static size_t getArenaBytes(double sampleRate, int samplesPerBlock) noexcept {
+            return (Stages::getArenaBytes(sampleRate, samplesPerBlock) + ... + 0);
+        }
+
+        void prepare(Arena& arena, const CoefficientTables& tables, double sampleRate, int samplesPerBlock) {
+            std::apply([&](auto&... stage) { (stage.prepare(arena, tables, sampleRate, samplesPerBlock), ...); }, stages);
+            reset();
+        }
+
+        void process(const Parameters& parameters, float* left, float* right, int numSamples) noexcept {
+            processStages(parameters, left, right, numSamples, std::index_sequence_for<Stages...>());
+        }
+
+        void reset() noexcept {
+            std::apply([](auto&... stage) { (stage.reset(), ...); }, stages);
+        }
+
+        void setQuality(Quality quality) noexcept {
+            controlInterval = quality == Quality::Full ? 1 : reducedControlInterval;
+            std::apply([quality](auto&... stage) { (stage.setQuality(quality), ...); }, stages);
+        }
+
+        static void applyResponse(const Parameters& parameters, const CoefficientTables& tables, ResponseGrid& grid) noexcept {
+            (applyResponseOf<Stages>(parameters, tables, grid), ...);
+        }
+
+    private:
+        //==============================================================================
+        template <typename Stage, typename Function>
+        static void forEachParameterOf(Function& fn) {
+            fn(Stage::enable);
+
+            for (const auto& parameter : Stage::parameters) {
+                fn(parameter);
+            }
+        }
+
+        template <typename Stage>
+        static void applyResponseOf(const Parameters& parameters, const CoefficientTables& tables, ResponseGrid& grid) noexcept {
+            if (parameters.get(Stage::enable.index) > 0.5f) {
+                Stage::applyResponse(parameters, tables, grid);
+            }
+        }
+
+        template <size_t... indices>
+        void processStages(const Parameters& parameters, float* left, float* right, int numSamples, std::index_sequence<indices...>) noexcept {
+            const auto isUpdateBlock = ++blocksSinceUpdate >= controlInterval;
+
+            if (isUpdateBlock) {
+                blocksSinceUpdate = 0;
+            }
+
+            (processStage<indices>(parameters, left, right, numSamples, isUpdateBlock), ...);
+        }
+
+        template <size_t index>
+        void processStage(const Parameters& parameters, float* left, float* right, int numSamples, bool isUpdateBlock) noexcept {
+            using Stage = std::tuple_element_t<index, std::tuple<Stages...>>;
+            auto& stage = std::get<index>(stages);
+
+            const auto isEnabled = parameters.get(Stage::enable.index) > 0.5f;
+
+            if (! isEnabled) {
+                wasEnabled[index] = false;
+                return;
+            }
+
+            const auto isReturning = ! wasEnabled[index];
+
+            if (isReturning) {
+                stage.reset();
+                wasEnabled[index] = true;
+            }
+
+            // a stage coming back in picks its parameters up straight away
+            if (isUpdateBlock || isReturning) {
+                stage.update(parameters);
+            }
+
+            stage.process(left, right, numSamples);
+        }
+
+        //==============================================================================
+        std::tuple<Stages...> stages;
+        bool wasEnabled[numStages] {};
+
+        int controlInterval { 1 };
+        int blocksSinceUpdate { 0 };
+    };
+
+    //==============================================================================
+    // to add a stage: declare it as above, give its parameters ParameterIds, and
+    // list it here
+    using FxStages = FxChain<DelayStage, AllPassStage>;
+}
@@ -0,0 +1,264 @@
+#include "GridRenderer.h"
+#include <limits>
+
+#include "Engine.h"
+
+//==============================================================================
+struct GridRenderer::Worker {
+    process::Parameters parameters;
+    process::Engine engine { parameters };
+
+    AudioBuffer<float> output;
+};
+
+//==============================================================================
+GridRenderer::GridRenderer(const File& inputFile, Options newOptions)
+    : options(std::move(newOptions))
+    , pool(options.numThreads)
+{
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(inputFile));
+
+    if (reader == nullptr) {
+        ConsoleApplication::fail("Can't read " + inputFile.getFullPathName());
+    }
+
+    if (reader->lengthInSamples > std::numeric_limits<int>::max()) {
+        ConsoleApplication::fail(inputFile.getFileName() + " is too long to hold in memory");
+    }
+
+    // mono material goes to both sides, anything wider uses its front pair
+    sampleRate = reader->sampleRate;
+    input.setSize(2, (int)reader->lengthInSamples);
+    reader->read(&input, 0, input.getNumSamples(), 0, true, true);
+
+    if (reader->numChannels == 1) {
+        input.copyFrom(1, 0, input, 0, 0, input.getNumSamples());
+    }
+}
+
+GridRenderer::~GridRenderer() {
+}
+
+void GridRenderer::addAxis(const String& spec) {
+    Axis axis;
+    axis.parameterID = spec.upToFirstOccurrenceOf("=", false, false).trim();
+
+    if (! process::Parameters::findId(axis.parameterID.toRawUTF8(), axis.index)) {
+        ConsoleApplication::fail("Unknown parameter " + axis.parameterID);
+    }
+
+    const auto values = spec.fromFirstOccurrenceOf("=", false, false).trim();
+
+    if (values.containsChar(':')) {
+        const auto range = StringArray::fromTokens(values, ":", {});
+        const auto count = range.size() == 3 ? range[2].getIntValue() : 0;
+
+        if (count < 1) {
+            ConsoleApplication::fail("Give a range as from:to:count, not " + values);
+        }
+
+        const auto from = range[0].getFloatValue();
+        const auto to = range[1].getFloatValue();
+
+        for (int i = 0; i < count; ++i) {
+            axis.values.push_back(count == 1 ? from : from + (to - from) * (float)i / (float)(count - 1));
+        }
+    } else {
+        for (const auto& value : StringArray::fromTokens(values, ",", {})) {
+            if (value.trim().isNotEmpty()) {
+                axis.values.push_back(value.getFloatValue());
+            }
+        }
+    }
+
+    if (axis.values.empty()) {
+        ConsoleApplication::fail("No values for " + axis.parameterID);
+    }
+
+    axes.push_back(std::move(axis));
+}
+
+void GridRenderer::setBaseValue(process::ParameterId index, float value) {
+    baseValues.emplace_back(index, value);
+}
+
+int GridRenderer::getNumRenders() const noexcept {
+    int64 count = 1;
+
+    for (const auto& axis : axes) {
+        count *= (int64)axis.values.size();
+    }
+
+    return (int)jmin(count, (int64)std::numeric_limits<int>::max());
+}
+
+// the first axis varies slowest, so the index reads like nested loops
+float GridRenderer::getValue(int renderIndex, size_t axis) const noexcept {
+    auto stride = 1;
+
+    for (auto later = axis + 1; later < axes.size(); ++later) {
+        stride *= (int)axes[later].values.size();
+    }
+
+    return axes[axis].values[(size_t)((renderIndex / stride) % (int)axes[axis].values.size())];
+}
+
+String GridRenderer::getFileName(int renderIndex) const {
+    return "render_" + String(renderIndex).paddedLeft('0', String(getNumRenders() - 1).length()) + ".wav";
+}
+
+//==============================================================================
+double GridRenderer::run() {
+    const auto numRenders = getNumRenders();
+
+    results.assign((size_t)numRenders, {});
+    nextRender = 0;
+    failedRender = -1;
+
+    if (! options.outputDirectory.createDirectory()) {
+        ConsoleApplication::fail("Can't create " + options.outputDirectory.getFullPathName());
+    }
+
+    // one long-lived job per worker, each with its own engine, pulling renders until none are left
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<WorkStealingPool::Job> jobs;
+
+    for (int i = 0; i < jmin(pool.getNumThreads(), numRenders); ++i) {
+        workers.push_back(std::make_unique<Worker>());
+
+        jobs.emplace_back([this, worker = workers.back().get(), numRenders] {
+            for (auto index = nextRender++; index < numRenders; index = nextRender++) {
+                if (! render(*worker, index)) {
+                    failedRender = index;
+                }
+            }
+        });
+    }
+
+    const auto start = Time::getMillisecondCounterHiRes();
+    pool.runBatch(jobs);
+    const auto seconds = (Time::getMillisecondCounterHiRes() - start) / 1000.;
+
+    // fail() throws, so the workers only report back
+    if (failedRender >= 0) {
+        ConsoleApplication::fail("Can't write " + options.outputDirectory.getChildFile(getFileName(failedRender)).getFullPathName());
+    }
+
+    writeIndex();
+
+    return seconds;
+}
+
+bool GridRenderer::render(Worker& worker, int renderIndex) {
+    auto& parameters = worker.parameters;
+
+    for (const auto& base : baseValues) {
+        parameters.set(base.first, base.second);
+    }
+
+    for (size_t axis = 0; axis < axes.size(); ++axis) {
+        parameters.set(axes[axis].index, getValue(renderIndex, axis));
+    }
+
+    auto& engine = worker.engine;
+    engine.prepare(AudioChannelSet::stereo(), sampleRate, options.blockSize);
+
+    // run on over silence for the latency, then drop it from the front
+    const auto latency = engine.getLatencyInSamples();
+    const auto length = input.getNumSamples();
+
+    auto& output = worker.output;
+    output.setSize(2, length + latency, false, false, true);
+    output.clear();
+
+    for (int ch = 0; ch < 2; ++ch) {
+        output.copyFrom(ch, 0, input, ch, 0, length);
+    }
+
+    for (int position = 0; position < output.getNumSamples(); position += options.blockSize) {
+        const auto numSamples = jmin(options.blockSize, output.getNumSamples() - position);
+        AudioBuffer<float> block(output.getArrayOfWritePointers(), 2, position, numSamples);
+
+        engine.process(block);
+    }
+
+    const auto* left = output.getReadPointer(0, latency);
+    const auto* right = output.getReadPointer(1, latency);
+
+    double sumLeft = 0., sumRight = 0., sumProduct = 0.;
+    float peak = 0.f;
+
+    for (int i = 0; i < length; ++i) {
+        sumLeft += (double)left[i] * left[i];
+        sumRight += (double)right[i] * right[i];
+        sumProduct += (double)left[i] * right[i];
+        peak = jmax(peak, std::abs(left[i]), std::abs(right[i]));
+    }
+
+    auto& metrics = results[(size_t)renderIndex];
+    metrics.rms[0] = (float)std::sqrt(sumLeft / jmax(1, length));
+    metrics.rms[1] = (float)std::sqrt(sumRight / jmax(1, length));
+    metrics.peak = peak;
+    metrics.correlation = sumLeft > 0. && sumRight > 0. ? (float)(sumProduct / std::sqrt(sumLeft * sumRight)) : 0.f;
+
+    if (options.writeAudio) {
+        const auto file = options.outputDirectory.getChildFile(getFileName(renderIndex));
+        file.deleteFile();
+
+        WavAudioFormat wav;
+        std::unique_ptr<FileOutputStream> stream(file.createOutputStream());
+        std::unique_ptr<AudioFormatWriter> writer(stream != nullptr ? wav.createWriterFor(stream.get(), sampleRate, 2, 24, {}, 0)
+                                                                    : nullptr);
+
+        if (writer == nullptr) {
+            return false;
+        }
+
+        stream.release();
+
+        const float* channels[] = {left, right};
+        return writer->writeFromFloatArrays(channels, 2, length);
+    }
+
+    return true;
+}
+
+void GridRenderer::writeIndex() const {
+    const auto file = options.outputDirectory.getChildFile("index.csv");
+    file.deleteFile();
+
+    FileOutputStream stream(file);
+
+    if (stream.failedToOpen()) {
+        ConsoleApplication::fail("Can't write " + file.getFullPathName());
+    }
+
+    stream << "render";
+
+    for (const auto& axis : axes) {
+        stream << "," << axis.parameterID;
+    }
+
+    stream << ",file,rms left,rms right,peak,peak dBFS,correlation\n";
+
+    for (int i = 0; i < (int)results.size(); ++i) {
+        const auto& metrics = results[(size_t)i];
+
+        stream << String(i);
+
+        for (size_t axis = 0; axis < axes.size(); ++axis) {
+            stream << "," << String(getValue(i, axis));
+        }
+
+        stream << "," << (options.writeAudio ? getFileName(i) : String())
+               << "," << String(metrics.rms[0])
+               << "," << String(metrics.rms[1])
+               << "," << String(metrics.peak)
+               << "," << String(Decibels::gainToDecibels(metrics.peak), 2)
+               << "," << String(metrics.correlation)
+               << "\n";
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+
+#include "Parameters.h"
+#include "WorkStealingPool.h"
+
+//==============================================================================
+// Renders one input file once per combination of a parameter grid, for sound
+// design sweeps and regression surfaces. The input is read once and shared;
+// every pool worker runs its own process::Engine, with no plugin wrapper, and
+// takes the next combination as soon as it's done with the last. Each render
+// gets a freshly prepared engine, so it matches a fresh plugin instance.
+class GridRenderer {
+public:
+    struct Options {
+        int blockSize { 512 };
+        int numThreads { SystemStats::getNumCpus() };
+        File outputDirectory;       // the CSV index, and the renders unless writeAudio is off
+        bool writeAudio { true };
+    };
+
+    struct Metrics {
+        float rms[2] {};
+        float peak { 0.f };
+        float correlation { 0.f };  // between left and right, 0 if either is silent
+    };
+
+    GridRenderer(const File& input, Options);
+    ~GridRenderer();
+
+    // "id=a,b,c" for a list of plain values, "id=from:to:count" for evenly spaced ones
+    void addAxis(const String& spec);
+
+    // a value every render starts from, before its grid values are applied
+    void setBaseValue(process::ParameterId, float value);
+
+    int getNumRenders() const noexcept;
+
+    // renders everything and writes index.csv; returns the wall time in seconds
+    double run();
+
+private:
+    //==============================================================================
+    struct Axis {
+        process::ParameterId index;
+        String parameterID;
+        std::vector<float> values;
+    };
+
+    struct Worker;
+
+    // false if the render couldn't be written
+    bool render(Worker&, int renderIndex);
+    float getValue(int renderIndex, size_t axis) const noexcept;
+    String getFileName(int renderIndex) const;
+    void writeIndex() const;
+
+    //==============================================================================
+    const Options options;
+
+    AudioBuffer<float> input;
+    double sampleRate { 0. };
+
+    std::vector<Axis> axes;
+    std::vector<std::pair<process::ParameterId, float>> baseValues;
+    std::vector<Metrics> results;
+
+    std::atomic<int> nextRender { 0 };
+    std::atomic<int> failedRender { -1 };
+    WorkStealingPool pool;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GridRenderer)
+};
@@ -0,0 +1,1195 @@
+#include "Headless.h"
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+#include "AllPassBank.h"
+#include "ChunkedRenderer.h"
+#include "Coefficients.h"
+#include "Engine.h"
+#include "GridRenderer.h"
+#include "HostSimulator.h"
+#include "Kernels.h"
+#include "MultiStreamEngine.h"
+#include "PantheonDsp.h"
+#include "PluginProcessor.h"
+#include "ResponseDisplay.h"
+#include "SpectralShaper.h"
+#include "StereoDelay.h"
+
+#if JUCE_LINUX
+ #include <malloc.h>
+#elif JUCE_MAC
+ #include <malloc/malloc.h>
+#endif
+
+namespace headless {
+    //==============================================================================
+    static int getIntOption(const ArgumentList& args, const String& option, int defaultValue) {
+        const auto value = args.getValueForOption(option);
+        return value.isNotEmpty() ? value.getIntValue() : defaultValue;
+    }
+
+    static double getDoubleOption(const ArgumentList& args, const String& option, double defaultValue) {
+        const auto value = args.getValueForOption(option);
+        return value.isNotEmpty() ? value.getDoubleValue() : defaultValue;
+    }
+
+    static Array<File> getInputFiles(const ArgumentList& args) {
+        Array<File> files;
+
+        for (const auto& argument : args.arguments) {
+            if (! argument.isOption()) {
+                files.add(argument.resolveAsExistingFile());
+            }
+        }
+
+        return files;
+    }
+
+    // sets a parameter by ID to a plain, unnormalised value
+    static void setParameter(AudioProcessor& processor, const String& parameterID, float value) {
+        for (auto* parameter : processor.getParameters()) {
+            if (auto* ranged = dynamic_cast<RangedAudioParameter*>(parameter)) {
+                if (ranged->getParameterID() == parameterID) {
+                    ranged->setValueNotifyingHost(ranged->convertTo0to1(value));
+                    return;
+                }
+            }
+        }
+
+        ConsoleApplication::fail("Unknown parameter " + parameterID);
+    }
+
+    // "--params=id:value,id:value" as plain parameter values
+    static void applyParameterOptions(AudioProcessor& processor, const ArgumentList& args) {
+        for (const auto& setting : StringArray::fromTokens(args.getValueForOption("--params"), ",", {})) {
+            if (setting.isNotEmpty()) {
+                setParameter(processor, setting.upToFirstOccurrenceOf(":", false, false).trim(),
+                             setting.fromFirstOccurrenceOf(":", false, false).getFloatValue());
+            }
+        }
+    }
+
+    //==============================================================================
+    static void runStreams(const ArgumentList& args) {
+        MultiStreamEngine engine(getIntOption(args, "--threads", SystemStats::getNumCpus()),
+                                 getIntOption(args, "--block", 512));
+
+        const auto outputDirectory = args.containsOption("--out") ? args.getExistingFolderForOption("--out") : File();
+
+        for (const auto& file : getInputFiles(args)) {
+            engine.addFileStream(file, outputDirectory != File() ? outputDirectory.getChildFile(file.getFileNameWithoutExtension() + "_pantheon.wav")
+                                                                 : File());
+        }
+
+        const auto numLoopbacks = getIntOption(args, "--loopback", engine.getNumStreams() == 0 ? SystemStats::getNumCpus() : 0);
+
+        for (int i = 0; i < numLoopbacks; ++i) {
+            engine.addLoopbackStream(getDoubleOption(args, "--rate", 48000.), getDoubleOption(args, "--seconds", 10.));
+        }
+
+        const auto wallSeconds = engine.run();
+
+        int64 totalSamples = 0;
+        double audioSeconds = 0.;
+
+        std::cout << "stream, blocks, mean latency ms, worst latency ms, process ms, deadline misses" << std::endl;
+
+        for (const auto& stats : engine.getStats()) {
+            std::cout << stats.name << ", "
+                      << stats.blocksProcessed << ", "
+                      << stats.totalLatencyMs / jmax(1, stats.blocksProcessed) << ", "
+                      << stats.worstLatencyMs << ", "
+                      << stats.totalProcessMs << ", "
+                      << stats.deadlineMisses << std::endl;
+
+            totalSamples += stats.samplesProcessed;
+            audioSeconds += (double)stats.samplesProcessed / stats.sampleRate;
+        }
+
+        std::cout << engine.getNumStreams() << " streams on " << engine.getNumThreads() << " threads: "
+                  << wallSeconds << " s wall, "
+                  << (double)totalSamples / wallSeconds << " samples/s, "
+                  << audioSeconds / wallSeconds << "x realtime" << std::endl;
+    }
+
+    //==============================================================================
+    static void runHostSimulation(const ArgumentList& args) {
+        HostSimulator simulator((uint32)getIntOption(args, "--seed", 1), (float)getDoubleOption(args, "--jump", 0.25));
+
+        const auto scripts = getInputFiles(args);
+        simulator.loadScript(scripts.isEmpty() ? HostSimulator::getDefaultScript() : scripts.getFirst().loadFileAsString());
+        simulator.run();
+
+        double worstCallMs = 0., worstPrepareMs = 0.;
+        int discontinuities = 0;
+
+        std::cout << "step, calls, prepare ms, mean call ms, worst call ms, worst call size, discontinuities, worst jump" << std::endl;
+
+        for (const auto& stats : simulator.getStats()) {
+            std::cout << stats.description << ", "
+                      << stats.calls << ", "
+                      << stats.prepareMs << ", "
+                      << stats.totalCallMs / jmax(1, stats.calls) << ", "
+                      << stats.worstCallMs << ", "
+                      << stats.worstCallSize << ", "
+                      << stats.discontinuities << ", "
+                      << stats.worstJump << std::endl;
+
+            worstCallMs = jmax(worstCallMs, stats.worstCallMs);
+            worstPrepareMs = jmax(worstPrepareMs, stats.prepareMs);
+            discontinuities += stats.discontinuities;
+        }
+
+        std::cout << "worst call " << worstCallMs << " ms, worst prepare " << worstPrepareMs << " ms, "
+                  << discontinuities << " discontinuities" << std::endl;
+    }
+
+    //==============================================================================
+    static void printMemoryFootprint(const ArgumentList& args) {
+        const auto sampleRate = getDoubleOption(args, "--rate", 48000.);
+        const auto blockSize = getIntOption(args, "--block", 512);
+
+        const std::pair<const char*, AudioChannelSet> layouts[] = {
+            {"stereo", AudioChannelSet::stereo()},
+            {"5.1", AudioChannelSet::create5point1()},
+            {"7.1", AudioChannelSet::create7point1()},
+            {"7.1.4", AudioChannelSet::create7point1point4()},
+        };
+
+        std::cout << "layout, stage, bytes" << std::endl;
+
+        for (const auto& layout : layouts) {
+            AudioPluginAudioProcessor processor;
+
+            AudioProcessor::BusesLayout buses;
+            buses.inputBuses.add(layout.second);
+            buses.outputBuses.add(layout.second);
+
+            if (! processor.setBusesLayout(buses)) {
+                continue;
+            }
+
+            processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+            processor.prepareToPlay(sampleRate, blockSize);
+
+            for (const auto& section : processor.getMemoryFootprint()) {
+                std::cout << layout.first << ", " << section.name << ", " << (int64)section.bytes << std::endl;
+            }
+
+            std::cout << layout.first << ", total, " << (int64)processor.getMemoryFootprintInBytes() << std::endl;
+
+            processor.releaseResources();
+        }
+    }
+
+    //==============================================================================
+    // bytes the allocator has handed out and not had back, or -1 where there's no way to ask
+    static int64 getHeapBytesInUse() {
+       #if JUCE_LINUX && defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+        const auto info = mallinfo2();
+        return (int64)(info.uordblks + info.hblkhd);
+       #elif JUCE_LINUX && defined(__GLIBC__)
+        const auto info = mallinfo();
+        return (int64)(unsigned int)info.uordblks + (int64)(unsigned int)info.hblkhd;
+       #elif JUCE_MAC
+        malloc_statistics_t statistics;
+        malloc_zone_statistics(nullptr, &statistics);
+        return (int64)statistics.size_in_use;
+       #else
+        return -1;
+       #endif
+    }
+
+    // what each of N live instances costs, the first apart from the rest: it's
+    // the one that builds the resources the others share
+    static void runInstanceBenchmark(const ArgumentList& args) {
+        const auto numInstances = jmax(2, getIntOption(args, "--instances", 500));
+        const auto sampleRate = getDoubleOption(args, "--rate", 48000.);
+        const auto blockSize = getIntOption(args, "--block", 512);
+
+        SharedResourcePointer<process::CoefficientTableRegistry> tableRegistry;
+        SharedResourcePointer<process::FftRegistry> fftRegistry;
+
+        std::vector<std::unique_ptr<AudioPluginAudioProcessor>> processors;
+        processors.reserve((size_t)numInstances);
+
+        double firstMs = 0., restMs = 0.;
+        int64 firstHeapBytes = 0, restHeapBytes = 0;
+        const auto hasHeap = getHeapBytesInUse() >= 0;
+
+        for (int i = 0; i < numInstances; ++i) {
+            const auto heapBefore = getHeapBytesInUse();
+            const auto start = Time::getMillisecondCounterHiRes();
+
+            auto processor = std::make_unique<AudioPluginAudioProcessor>();
+            processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+            processor->prepareToPlay(sampleRate, blockSize);
+
+            const auto ms = Time::getMillisecondCounterHiRes() - start;
+            const auto heapBytes = getHeapBytesInUse() - heapBefore;
+
+            if (i == 0) {
+                firstMs = ms;
+                firstHeapBytes = heapBytes;
+            } else {
+                restMs += ms;
+                restHeapBytes += heapBytes;
+            }
+
+            processors.push_back(std::move(processor));
+        }
+
+        const auto numRest = numInstances - 1;
+        const auto arenaBytes = (int64)processors.front()->getMemoryFootprintInBytes();
+
+        std::cout << "instances, " << numInstances << std::endl
+                  << "arena bytes per instance, " << arenaBytes << std::endl
+                  << "first instance heap bytes, " << (hasHeap ? String(firstHeapBytes) : String("n/a")) << std::endl
+                  << "heap bytes per further instance, " << (hasHeap ? String(restHeapBytes / numRest) : String("n/a")) << std::endl
+                  << "first instance startup ms, " << firstMs << std::endl
+                  << "startup ms per further instance, " << restMs / numRest << std::endl
+                  << "total startup ms, " << firstMs + restMs << std::endl
+                  << "shared coefficient tables, " << (int64)tableRegistry->getNumLiveResources() << std::endl
+                  << "shared FFTs, " << (int64)fftRegistry->getNumLiveResources() << std::endl;
+
+        for (auto& processor : processors) {
+            processor->releaseResources();
+        }
+    }
+
+    //==============================================================================
+    // a session load in one process: N instances each restored from a state of
+    // their own, once the way setStateInformation did it before StateRestorer
+    // and then through it, both for what the loading thread is held up by and
+    // for the decode and apply that now happen later
+    static void runStateBenchmark(const ArgumentList& args) {
+        const auto numInstances = jmax(1, getIntOption(args, "--instances", 500));
+        const auto sampleRate = getDoubleOption(args, "--rate", 48000.);
+        const auto blockSize = getIntOption(args, "--block", 512);
+
+        std::vector<std::unique_ptr<AudioPluginAudioProcessor>> processors;
+        std::vector<MemoryBlock> states((size_t)numInstances);
+        Random random(1);
+
+        const auto randomise = [&random](AudioPluginAudioProcessor& processor) {
+            for (auto* parameter : processor.getParameters()) {
+                parameter->setValueNotifyingHost(random.nextFloat());
+            }
+        };
+
+        for (int i = 0; i < numInstances; ++i) {
+            auto processor = std::make_unique<AudioPluginAudioProcessor>();
+            processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+            processor->prepareToPlay(sampleRate, blockSize);
+
+            randomise(*processor);
+            processor->getStateInformation(states[(size_t)i]);
+
+            processors.push_back(std::move(processor));
+        }
+
+        // the pre-StateRestorer setStateInformation, replaceState and all
+        for (auto& processor : processors) {
+            randomise(*processor);
+        }
+
+        auto start = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numInstances; ++i) {
+            auto& apvts = processors[(size_t)i]->getValueTreeState();
+            const auto& state = states[(size_t)i];
+
+            if (const auto xml = AudioProcessor::getXmlFromBinary(state.getData(), (int)state.getSize())) {
+                if (xml->hasTagName(apvts.state.getType())) {
+                    apvts.replaceState(ValueTree::fromXml(*xml));
+                }
+            }
+        }
+
+        const auto synchronousMs = Time::getMillisecondCounterHiRes() - start;
+
+        for (auto& processor : processors) {
+            randomise(*processor);
+        }
+
+        start = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numInstances; ++i) {
+            processors[(size_t)i]->setStateInformation(states[(size_t)i].getData(), (int)states[(size_t)i].getSize());
+        }
+
+        const auto submitMs = Time::getMillisecondCounterHiRes() - start;
+
+        // the same restores decoded and applied as well, the work that replaced
+        // replaceState. Done straight after each submit, before the analysis
+        // thread can have finished one, so every decode is counted here.
+        for (auto& processor : processors) {
+            processor->finishRestoringState();
+            randomise(*processor);
+        }
+
+        start = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numInstances; ++i) {
+            processors[(size_t)i]->setStateInformation(states[(size_t)i].getData(), (int)states[(size_t)i].getSize());
+            processors[(size_t)i]->finishRestoringState();
+        }
+
+        const auto restoreMs = Time::getMillisecondCounterHiRes() - start;
+
+        std::cout << "restore, instances, total ms, ms per instance" << std::endl
+                  << "replaceState, " << numInstances << ", " << synchronousMs << ", " << synchronousMs / numInstances << std::endl
+                  << "submit only, " << numInstances << ", " << submitMs << ", " << submitMs / numInstances << std::endl
+                  << "submit, decode and apply, " << numInstances << ", " << restoreMs << ", " << restoreMs / numInstances << std::endl;
+
+        for (auto& processor : processors) {
+            processor->releaseResources();
+        }
+    }
+
+    //==============================================================================
+    static void runSpectralBenchmark(const ArgumentList& args) {
+        const auto sampleRate = getDoubleOption(args, "--rate", 48000.);
+        const auto blockSize = getIntOption(args, "--block", 512);
+        const auto numBlocks = (int)(getDoubleOption(args, "--seconds", 30.) * sampleRate / blockSize);
+
+        struct Setup {
+            const char* name;
+            bool spectral;
+            int overlapIndex;
+        };
+
+        const Setup setups[] = {
+            {"time domain", false, 0},
+            {"spectral 2x", true, 0},
+            {"spectral 4x", true, 1},
+            {"spectral 8x", true, 2},
+        };
+
+        AudioBuffer<float> buffer(2, blockSize);
+        MidiBuffer midi;
+        Random random(1);
+        double timeDomainMs = 0.;
+
+        std::cout << "mode, ms, ns/sample, x realtime, x time domain" << std::endl;
+
+        for (const auto& setup : setups) {
+            AudioPluginAudioProcessor processor;
+            setParameter(processor, "spectralMode", setup.spectral ? 1.f : 0.f);
+            setParameter(processor, "spectralOverlap", (float)setup.overlapIndex);
+            setParameter(processor, "spectralWidthHigh", 1.5f);
+            setParameter(processor, "spectralRotation", 90.f);
+            setParameter(processor, "delayLine", 0.3f);
+            setParameter(processor, "allPassFreq", 0.5f);
+
+            processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+            processor.prepareToPlay(sampleRate, blockSize);
+
+            double totalMs = 0.;
+
+            for (int block = 0; block < numBlocks; ++block) {
+                for (int ch = 0; ch < 2; ++ch) {
+                    for (int i = 0; i < blockSize; ++i) {
+                        buffer.setSample(ch, i, 0.25f * (2.f * random.nextFloat() - 1.f));
+                    }
+                }
+
+                const auto start = Time::getMillisecondCounterHiRes();
+                processor.processBlock(buffer, midi);
+                totalMs += Time::getMillisecondCounterHiRes() - start;
+            }
+
+            processor.releaseResources();
+
+            if (! setup.spectral) {
+                timeDomainMs = totalMs;
+            }
+
+            const auto numSamples = (double)numBlocks * blockSize;
+
+            std::cout << setup.name << ", "
+                      << totalMs << ", "
+                      << 1.e6 * totalMs / numSamples << ", "
+                      << 1000. * numSamples / sampleRate / totalMs << ", "
+                      << totalMs / timeDomainMs << std::endl;
+        }
+    }
+
+    //==============================================================================
+    static void runChunkedRender(const ArgumentList& args) {
+        const auto inputs = getInputFiles(args);
+
+        if (inputs.size() != 1) {
+            ConsoleApplication::fail("Give exactly one input file");
+        }
+
+        ChunkedRenderer::Options options;
+        options.blockSize = getIntOption(args, "--block", options.blockSize);
+        options.numThreads = getIntOption(args, "--threads", options.numThreads);
+        options.chunkSeconds = getDoubleOption(args, "--chunk", options.chunkSeconds);
+        options.tolerance = (float)getDoubleOption(args, "--tolerance", options.tolerance);
+
+        {
+            AudioPluginAudioProcessor processor;
+            applyParameterOptions(processor, args);
+            processor.getStateInformation(options.state);
+        }
+
+        ChunkedRenderer renderer(inputs.getFirst(), options);
+
+        const auto warmUp = renderer.detectWarmUpSamples();
+        std::cout << "warm-up " << warmUp << " samples (" << 1000. * warmUp / renderer.getSampleRate() << " ms)" << std::endl;
+
+        if (args.containsOption("--out")) {
+            const auto output = args.getFileForOption("--out");
+            output.deleteFile();
+
+            WavAudioFormat wav;
+            std::unique_ptr<FileOutputStream> stream(output.createOutputStream());
+            std::unique_ptr<AudioFormatWriter> writer(stream != nullptr ? wav.createWriterFor(stream.get(), renderer.getSampleRate(), 2, 24, {}, 0)
+                                                                        : nullptr);
+
+            if (writer == nullptr) {
+                ConsoleApplication::fail("Can't write " + output.getFullPathName());
+            }
+
+            stream.release();
+
+            const auto seconds = renderer.render(*writer, warmUp);
+            std::cout << "rendered in " << seconds << " s, "
+                      << (double)renderer.getLengthInSamples() / renderer.getSampleRate() / seconds << "x realtime" << std::endl;
+        }
+
+        // the chunked render against one instance over the whole file
+        if (args.containsOption("--verify")) {
+            AudioBuffer<float> chunked, reference;
+            renderer.renderChunked(chunked, warmUp);
+            renderer.renderSingleThreaded(reference);
+
+            float worst = 0.f;
+
+            for (int ch = 0; ch < 2; ++ch) {
+                for (int i = 0; i < reference.getNumSamples(); ++i) {
+                    worst = jmax(worst, std::abs(chunked.getSample(ch, i) - reference.getSample(ch, i)));
+                }
+            }
+
+            std::cout << "worst difference to a single-threaded render " << worst << std::endl;
+
+            if (renderer.getNumQualityTransitions() > 0) {
+                ConsoleApplication::fail("An offline instance changed quality level " + String(renderer.getNumQualityTransitions()) + " times");
+            }
+
+            if (worst > options.tolerance) {
+                ConsoleApplication::fail("Chunked render is off by " + String(worst) + ", over the tolerance of " + String(options.tolerance));
+            }
+        }
+    }
+
+    //==============================================================================
+    static void runGridRender(const ArgumentList& args) {
+        const auto inputs = getInputFiles(args);
+
+        if (inputs.size() != 1) {
+            ConsoleApplication::fail("Give exactly one input file");
+        }
+
+        if (! args.containsOption("--out")) {
+            ConsoleApplication::fail("Give an output folder with --out");
+        }
+
+        GridRenderer::Options options;
+        options.blockSize = getIntOption(args, "--block", options.blockSize);
+        options.numThreads = getIntOption(args, "--threads", options.numThreads);
+        options.outputDirectory = args.getFileForOption("--out");
+        options.writeAudio = ! args.containsOption("--metrics-only");
+
+        GridRenderer renderer(inputs.getFirst(), options);
+
+        for (const auto& setting : StringArray::fromTokens(args.getValueForOption("--params"), ",", {})) {
+            if (setting.isNotEmpty()) {
+                const auto parameterID = setting.upToFirstOccurrenceOf(":", false, false).trim();
+                process::ParameterId index;
+
+                if (! process::Parameters::findId(parameterID.toRawUTF8(), index)) {
+                    ConsoleApplication::fail("Unknown parameter " + parameterID);
+                }
+
+                renderer.setBaseValue(index, setting.fromFirstOccurrenceOf(":", false, false).getFloatValue());
+            }
+        }
+
+        // axes inline, separated by ';', or one per line in a file
+        const auto gridSpec = args.getValueForOption("--axes");
+        const auto gridFile = File::getCurrentWorkingDirectory().getChildFile(gridSpec);
+
+        const auto axes = gridSpec.isNotEmpty() && gridFile.existsAsFile() ? StringArray::fromLines(gridFile.loadFileAsString())
+                                                                              : StringArray::fromTokens(gridSpec, ";", {});
+
+        for (const auto& axis : axes) {
+            if (axis.trim().isNotEmpty() && ! axis.trimStart().startsWithChar('#')) {
+                renderer.addAxis(axis);
+            }
+        }
+
+        const auto numRenders = renderer.getNumRenders();
+        std::cout << "rendering " << numRenders << " combinations" << std::endl;
+
+        const auto seconds = renderer.run();
+        std::cout << "rendered in " << seconds << " s, " << seconds / numRenders * 1000. << " ms per render" << std::endl;
+    }
+
+    //==============================================================================
+    // the same noise and settings through the plugin and through the C API
+    static void runDspBenchmark(const ArgumentList& args) {
+        const auto sampleRate = getDoubleOption(args, "--rate", 48000.);
+        const auto numSamples = (int)(sampleRate * getDoubleOption(args, "--seconds", 10.));
+
+        AudioBuffer<float> noise(2, numSamples);
+        Random random(1);
+
+        for (int ch = 0; ch < 2; ++ch) {
+            for (int i = 0; i < numSamples; ++i) {
+                noise.setSample(ch, i, 0.25f * (2.f * random.nextFloat() - 1.f));
+            }
+        }
+
+        const auto settings = StringArray::fromTokens(args.getValueForOption("--params"), ",", {});
+
+        std::cout << "block, plugin ns/call, planar ns/call, interleaved ns/call, planar x plugin, interleaved x plugin" << std::endl;
+
+        for (int blockSize = 16; blockSize <= getIntOption(args, "--block", 1024); blockSize *= 2) {
+            const auto numBlocks = numSamples / blockSize;
+            AudioBuffer<float> buffer(2, blockSize);
+            HeapBlock<float> frames((size_t)blockSize * 2);
+
+            AudioPluginAudioProcessor processor;
+            applyParameterOptions(processor, args);
+            processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+            processor.prepareToPlay(sampleRate, blockSize);
+
+            auto* dsp = pantheon_dsp_create(2);
+
+            for (const auto& setting : settings) {
+                if (setting.isNotEmpty()) {
+                    pantheon_dsp_set_param_by_id(dsp, setting.upToFirstOccurrenceOf(":", false, false).trim().toRawUTF8(),
+                                                 setting.fromFirstOccurrenceOf(":", false, false).getFloatValue());
+                }
+            }
+
+            pantheon_dsp_prepare(dsp, sampleRate, blockSize);
+
+            MidiBuffer midi;
+            double pluginMs = 0., planarMs = 0., interleavedMs = 0.;
+
+            for (int block = 0; block < numBlocks; ++block) {
+                for (int ch = 0; ch < 2; ++ch) {
+                    buffer.copyFrom(ch, 0, noise, ch, block * blockSize, blockSize);
+                }
+
+                auto start = Time::getMillisecondCounterHiRes();
+                processor.processBlock(buffer, midi);
+                pluginMs += Time::getMillisecondCounterHiRes() - start;
+
+                for (int ch = 0; ch < 2; ++ch) {
+                    buffer.copyFrom(ch, 0, noise, ch, block * blockSize, blockSize);
+                }
+
+                start = Time::getMillisecondCounterHiRes();
+                pantheon_dsp_process_planar(dsp, buffer.getArrayOfWritePointers(), blockSize);
+                planarMs += Time::getMillisecondCounterHiRes() - start;
+
+                for (int i = 0; i < blockSize; ++i) {
+                    frames[2 * i] = noise.getSample(0, block * blockSize + i);
+                    frames[2 * i + 1] = noise.getSample(1, block * blockSize + i);
+                }
+
+                start = Time::getMillisecondCounterHiRes();
+                pantheon_dsp_process_interleaved(dsp, frames, blockSize);
+                interleavedMs += Time::getMillisecondCounterHiRes() - start;
+            }
+
+            pantheon_dsp_destroy(dsp);
+            processor.releaseResources();
+
+            std::cout << blockSize << ", "
+                      << 1.e6 * pluginMs / numBlocks << ", "
+                      << 1.e6 * planarMs / numBlocks << ", "
+                      << 1.e6 * interleavedMs / numBlocks << ", "
+                      << planarMs / pluginMs << ", "
+                      << interleavedMs / pluginMs << std::endl;
+        }
+    }
+
+    //==============================================================================
+    // the first block after prepare against the ones after it, with and without
+    // the warm-up, on a fresh engine per trial
+    static void runWarmUpBenchmark(const ArgumentList& args) {
+        const auto sampleRate = getDoubleOption(args, "--rate", 48000.);
+        const auto blockSize = getIntOption(args, "--block", 512);
+        const auto numTrials = jmax(1, getIntOption(args, "--trials", 20));
+        const auto locksMemory = args.containsOption("--lock");
+
+        constexpr int numSteadyBlocks = 64;
+
+        AudioBuffer<float> noise(2, blockSize * (numSteadyBlocks + 1));
+        Random random(1);
+
+        for (int ch = 0; ch < 2; ++ch) {
+            for (int i = 0; i < noise.getNumSamples(); ++i) {
+                noise.setSample(ch, i, 0.25f * (2.f * random.nextFloat() - 1.f));
+            }
+        }
+
+        std::cout << "warm-up, prepare ms, first block us, worst first block us, steady block us, first x steady, memory locked" << std::endl;
+
+        for (auto warmsUp : {false, true}) {
+            AudioBuffer<float> buffer(2, blockSize);
+            std::vector<double> steadyMs((size_t)numSteadyBlocks);
+            double prepareMs = 0., firstMs = 0., worstFirstMs = 0., steadySumMs = 0.;
+            int numLocked = 0;
+
+            for (int trial = 0; trial < numTrials; ++trial) {
+                process::Parameters parameters;
+
+                for (const auto& setting : StringArray::fromTokens(args.getValueForOption("--params"), ",", {})) {
+                    process::ParameterId index;
+
+                    if (setting.isNotEmpty() && process::Parameters::findId(setting.upToFirstOccurrenceOf(":", false, false).trim().toRawUTF8(), index)) {
+                        parameters.set(index, setting.fromFirstOccurrenceOf(":", false, false).getFloatValue());
+                    }
+                }
+
+                process::Engine engine { parameters };
+                engine.setWarmUp(warmsUp);
+                engine.setLockMemory(locksMemory);
+
+                auto start = Time::getMillisecondCounterHiRes();
+                engine.prepare(AudioChannelSet::stereo(), sampleRate, blockSize);
+                prepareMs += Time::getMillisecondCounterHiRes() - start;
+                numLocked += engine.isMemoryLocked() ? 1 : 0;
+
+                for (int block = 0; block <= numSteadyBlocks; ++block) {
+                    for (int ch = 0; ch < 2; ++ch) {
+                        buffer.copyFrom(ch, 0, noise, ch, block * blockSize, blockSize);
+                    }
+
+                    start = Time::getMillisecondCounterHiRes();
+                    engine.process(buffer);
+                    const auto ms = Time::getMillisecondCounterHiRes() - start;
+
+                    if (block == 0) {
+                        firstMs += ms;
+                        worstFirstMs = jmax(worstFirstMs, ms);
+                    } else {
+                        steadyMs[(size_t)block - 1] = ms;
+                    }
+                }
+
+                // the median, so a preempted block doesn't count as steady state
+                std::nth_element(steadyMs.begin(), steadyMs.begin() + numSteadyBlocks / 2, steadyMs.end());
+                steadySumMs += steadyMs[numSteadyBlocks / 2];
+            }
+
+            std::cout << (warmsUp ? "on" : "off") << ", "
+                      << prepareMs / numTrials << ", "
+                      << 1000. * firstMs / numTrials << ", "
+                      << 1000. * worstFirstMs << ", "
+                      << 1000. * steadySumMs / numTrials << ", "
+                      << firstMs / steadySumMs << ", "
+                      << numLocked << "/" << numTrials << std::endl;
+        }
+    }
+
+    //==============================================================================
+    // every kernel variant this CPU runs, switched in through setOverride() the
+    // way the stages pick it up, against the generic one on the same random data
+    static void runKernelCheck(const ArgumentList& args) {
+        using namespace process::kernels;
+
+        const auto tolerance = (float)getDoubleOption(args, "--tolerance", 1.e-5);
+        const auto numTrials = jmax(1, getIntOption(args, "--trials", 200));
+
+        // odd lengths and offsets, so every head, tail and unaligned path runs
+        constexpr int maxLength = 1027;
+        constexpr int maxOffset = 15;
+
+        const auto& generic = *getTable(Isa::Generic);
+        const auto previous = get().isa;
+
+        std::vector<float> source(maxLength + maxOffset), reference(maxLength + maxOffset), result(maxLength + maxOffset);
+        Random random(1);
+        int numFailures = 0;
+
+        std::cout << "variant, kernel, worst difference" << std::endl;
+
+        for (const auto isa : {Isa::SSE2, Isa::AVX2, Isa::AVX512}) {
+            if (! setOverride(isa)) {
+                continue;
+            }
+
+            const auto& table = get();
+            jassert(table.isa == isa);
+
+            float worst[4] {};
+
+            for (int trial = 0; trial < numTrials; ++trial) {
+                const auto length = trial < 64 ? trial : random.nextInt(maxLength + 1);
+                const auto offset = random.nextInt(maxOffset + 1);
+                const auto gain = 4.f * random.nextFloat() - 2.f;
+                const auto step = (2.f * random.nextFloat() - 1.f) / (float)jmax(1, length);
+
+                for (size_t i = 0; i < source.size(); ++i) {
+                    source[i] = 2.f * random.nextFloat() - 1.f;
+                    reference[i] = 2.f * random.nextFloat() - 1.f;
+                }
+
+                // each kernel starts from where the generic one left the data, so differences don't add up
+                const auto compare = [&](int kernel) {
+                    for (size_t i = 0; i < result.size(); ++i) {
+                        worst[kernel] = jmax(worst[kernel], std::abs(result[i] - reference[i]));
+                    }
+                };
+
+                auto* expected = reference.data() + offset;
+                auto* actual = result.data() + offset;
+                const auto* input = source.data() + offset;
+
+                result = reference;
+                generic.multiply(expected, gain, length);
+                table.multiply(actual, gain, length);
+                compare(0);
+
+                result = reference;
+                generic.multiplyRamp(expected, gain, step, length);
+                table.multiplyRamp(actual, gain, step, length);
+                compare(1);
+
+                result = reference;
+                generic.multiplyAdd(expected, input, gain, length);
+                table.multiplyAdd(actual, input, gain, length);
+                compare(2);
+
+                result = reference;
+                generic.multiplyAddRamp(expected, input, gain, step, length);
+                table.multiplyAddRamp(actual, input, gain, step, length);
+                compare(3);
+            }
+
+            const char* kernelNames[] = {"multiply", "multiplyRamp", "multiplyAdd", "multiplyAddRamp"};
+
+            for (int kernel = 0; kernel < 4; ++kernel) {
+                std::cout << table.name << ", " << kernelNames[kernel] << ", " << worst[kernel] << std::endl;
+                numFailures += worst[kernel] > tolerance ? 1 : 0;
+            }
+        }
+
+        setOverride(previous);
+
+        if (numFailures > 0) {
+            ConsoleApplication::fail(String(numFailures) + " kernels differ from the generic ones by more than " + String(tolerance));
+        }
+    }
+
+    //==============================================================================
+    // each interpolator at a fixed fractional delay and swept sample by sample,
+    // against the linear one at a fixed delay, which is all the delay did before
+    static void runDelayBenchmark(const ArgumentList& args) {
+        using Interpolation = process::StereoDelay::Interpolation;
+
+        const auto sampleRate = getDoubleOption(args, "--rate", 48000.);
+        const auto blockSize = getIntOption(args, "--block", 512);
+        const auto numBlocks = jmax(1, (int)(getDoubleOption(args, "--seconds", 30.) * sampleRate / blockSize));
+        const auto maxDelayInMilliseconds = 20.;
+
+        AudioBuffer<float> buffer(2, blockSize);
+        HeapBlock<float> leftDelays((size_t)blockSize), rightDelays((size_t)blockSize);
+        Random random(1);
+
+        const auto time = [&](Interpolation interpolation, bool isSwept) {
+            process::Arena arena;
+            arena.allocate(process::StereoDelay::getArenaBytes(sampleRate, maxDelayInMilliseconds));
+
+            process::StereoDelay delay;
+            delay.prepare(arena, sampleRate, maxDelayInMilliseconds);
+            delay.setInterpolation(interpolation);
+            delay.setDelay(0, 10.5f);
+            delay.setDelay(1, 200.25f);
+
+            double totalMs = 0.;
+
+            for (int block = 0; block < numBlocks; ++block) {
+                for (int ch = 0; ch < 2; ++ch) {
+                    for (int i = 0; i < blockSize; ++i) {
+                        buffer.setSample(ch, i, 0.25f * (2.f * random.nextFloat() - 1.f));
+                    }
+                }
+
+                // a slow triangle over a few hundred samples of delay
+                for (int i = 0; i < blockSize; ++i) {
+                    const auto phase = (float)((block * blockSize + i) % 96000) / 48000.f;
+                    leftDelays[i] = 10.5f + 300.f * (phase < 1.f ? phase : 2.f - phase);
+                    rightDelays[i] = 200.25f + 0.5f * leftDelays[i];
+                }
+
+                const auto start = Time::getMillisecondCounterHiRes();
+
+                if (isSwept) {
+                    delay.process(buffer.getWritePointer(0), buffer.getWritePointer(1), leftDelays, rightDelays, blockSize);
+                } else {
+                    delay.process(buffer.getWritePointer(0), buffer.getWritePointer(1), blockSize);
+                }
+
+                totalMs += Time::getMillisecondCounterHiRes() - start;
+            }
+
+            return 1.e6 * totalMs / ((double)numBlocks * blockSize);
+        };
+
+        const std::pair<const char*, Interpolation> interpolations[] = {
+            {"linear", Interpolation::Linear},
+            {"lagrange", Interpolation::Lagrange},
+            {"thiran", Interpolation::Thiran},
+        };
+
+        const auto baselineNs = time(Interpolation::Linear, false);
+
+        std::cout << "interpolation, fixed ns/sample, swept ns/sample, fixed x linear, swept x linear" << std::endl;
+
+        for (const auto& interpolation : interpolations) {
+            const auto fixedNs = time(interpolation.second, false);
+            const auto sweptNs = time(interpolation.second, true);
+
+            std::cout << interpolation.first << ", "
+                      << fixedNs << ", "
+                      << sweptNs << ", "
+                      << fixedNs / baselineNs << ", "
+                      << sweptNs / baselineNs << std::endl;
+        }
+    }
+
+    //==============================================================================
+    // the bank at each stage count against the two FirstOrderTPTFilters per
+    // channel the Phase control ran through before it, all at a fixed cutoff
+    static void runAllPassBenchmark(const ArgumentList& args) {
+        const auto sampleRate = getDoubleOption(args, "--rate", 48000.);
+        const auto blockSize = getIntOption(args, "--block", 512);
+        const auto numBlocks = jmax(1, (int)(getDoubleOption(args, "--seconds", 30.) * sampleRate / blockSize));
+        const auto cutoff = 1000.f;
+
+        AudioBuffer<float> buffer(2, blockSize);
+        Random random(1);
+
+        const auto fillNoise = [&] {
+            for (int ch = 0; ch < 2; ++ch) {
+                for (int i = 0; i < blockSize; ++i) {
+                    buffer.setSample(ch, i, 0.25f * (2.f * random.nextFloat() - 1.f));
+                }
+            }
+        };
+
+        const auto toNsPerSample = [&](double totalMs) {
+            return 1.e6 * totalMs / ((double)numBlocks * blockSize);
+        };
+
+        const auto timeChain = [&] {
+            using AllPassChain = dsp::ProcessorChain<dsp::FirstOrderTPTFilter<float>, dsp::FirstOrderTPTFilter<float>>;
+            AllPassChain chains[2];
+
+            for (auto& chain : chains) {
+                chain.prepare({sampleRate, (uint32)blockSize, 1});
+                chain.get<0>().setType(dsp::FirstOrderTPTFilterType::allpass);
+                chain.get<0>().setCutoffFrequency(cutoff);
+                chain.get<1>().setType(dsp::FirstOrderTPTFilterType::allpass);
+                chain.get<1>().setCutoffFrequency(cutoff);
+            }
+
+            double totalMs = 0.;
+
+            for (int block = 0; block < numBlocks; ++block) {
+                fillNoise();
+
+                const auto start = Time::getMillisecondCounterHiRes();
+                dsp::AudioBlock<float> audioBlock(buffer);
+
+                for (int ch = 0; ch < 2; ++ch) {
+                    auto channelBlock = audioBlock.getSingleChannelBlock((size_t)ch);
+                    dsp::ProcessContextReplacing<float> context(channelBlock);
+                    chains[ch].process(context);
+                }
+
+                totalMs += Time::getMillisecondCounterHiRes() - start;
+            }
+
+            return toNsPerSample(totalMs);
+        };
+
+        SharedResourcePointer<process::CoefficientTableRegistry> tableRegistry;
+        const auto tables = tableRegistry->get(sampleRate);
+
+        const auto timeBank = [&](int numStages) {
+            process::AllPassBank bank;
+            bank.prepare(*tables);
+            bank.setNumStages(numStages);
+
+            // one octave each side, so the stages don't all share a coefficient
+            const auto position = std::log10(cutoff) / std::log10((float)sampleRate / 2.f);
+            bank.setCutoffPosition(0, position, 1.f);
+            bank.setCutoffPosition(1, position, 1.f);
+
+            double totalMs = 0.;
+
+            for (int block = 0; block < numBlocks; ++block) {
+                fillNoise();
+
+                const auto start = Time::getMillisecondCounterHiRes();
+                bank.process(buffer.getWritePointer(0), buffer.getWritePointer(1), blockSize);
+                totalMs += Time::getMillisecondCounterHiRes() - start;
+            }
+
+            return toNsPerSample(totalMs);
+        };
+
+        const auto chainNs = timeChain();
+
+        std::cout << "filter, stages, ns/sample, x two-stage chain" << std::endl;
+        std::cout << "tpt chain, 2, " << chainNs << ", 1" << std::endl;
+
+        for (auto numStages : {2, 4, 8, 16}) {
+            const auto bankNs = timeBank(numStages);
+            std::cout << "bank, " << numStages << ", " << bankNs << ", " << bankNs / chainNs << std::endl;
+        }
+    }
+
+    //==============================================================================
+    // the editor laid out and painted into an Image, with no window: per width
+    // from the 200-px minimum to the 1080-px maximum, first with the parameters
+    // still, then with all of them sweeping through their ranges
+    static void runGuiBenchmark(const ArgumentList& args) {
+        const auto numFrames = jmax(1, getIntOption(args, "--frames", 200));
+        const auto scale = (float)jlimit(0.5, 4., getDoubleOption(args, "--scale", 1.));
+
+        Array<int> widths;
+
+        for (const auto& width : StringArray::fromTokens(args.getValueForOption("--sizes"), ",", {})) {
+            if (width.isNotEmpty()) {
+                widths.add(jlimit(200, 1080, width.getIntValue()));
+            }
+        }
+
+        if (widths.isEmpty()) {
+            widths.addArray({200, 300, 400, 540, 720, 900, 1080});
+        }
+
+        // a full sweep up and down takes this many frames, each parameter a bit behind the last
+        constexpr int sweepFrames = 120;
+
+        AudioPluginAudioProcessor processor;
+        applyParameterOptions(processor, args);
+        processor.setRateAndBufferSizeDetails(48000., 512);
+        processor.prepareToPlay(48000., 512);
+
+        std::unique_ptr<AudioProcessorEditor> editor(processor.createEditorIfNeeded());
+
+        if (editor == nullptr) {
+            ConsoleApplication::fail("No editor");
+        }
+
+        // as a host shows it, only never on the desktop
+        editor->setVisible(true);
+
+        // its timer doesn't run here, so the sweep drives it directly
+        ResponseDisplay* display = nullptr;
+
+        for (auto* child : editor->getChildren()) {
+            if (auto* found = dynamic_cast<ResponseDisplay*>(child)) {
+                display = found;
+            }
+        }
+
+        std::cout << "width, height, sweep, layout us, update us, paint ms, worst paint ms, median paint ms" << std::endl;
+
+        for (auto width : widths) {
+            const auto height = 2 * width;
+            Image image(Image::ARGB, roundToInt(scale * (float)width), roundToInt(scale * (float)height), true);
+            std::vector<double> paintMs((size_t)numFrames);
+
+            // so the still frames draw the curve at this width
+            editor->setSize(width, height);
+
+            if (display != nullptr) {
+                display->updateNow();
+            }
+
+            for (auto sweeps : {false, true}) {
+                double layoutMs = 0., updateMs = 0., worstPaintMs = 0.;
+
+                for (int frame = 0; frame < numFrames; ++frame) {
+                    // a pixel off and back each frame, so the whole grid is laid out again
+                    auto start = Time::getMillisecondCounterHiRes();
+                    editor->setSize(width, height - (frame & 1));
+                    layoutMs += Time::getMillisecondCounterHiRes() - start;
+
+                    if (sweeps) {
+                        // the attachments move the controls straight away on the message thread
+                        start = Time::getMillisecondCounterHiRes();
+
+                        for (int i = 0; i < process::Parameters::numParameters; ++i) {
+                            const auto& info = process::Parameters::getInfo((process::ParameterId)i);
+                            const auto phase = (float)((frame + 7 * i) % sweepFrames) / (0.5f * sweepFrames);
+                            const auto position = phase < 1.f ? phase : 2.f - phase;
+                            setParameter(processor, info.id, info.minimum + position * (info.maximum - info.minimum));
+                        }
+
+                        // and the response curves follow, as the display's timer would have them
+                        if (display != nullptr) {
+                            display->updateNow();
+                        }
+
+                        updateMs += Time::getMillisecondCounterHiRes() - start;
+                    }
+
+                    start = Time::getMillisecondCounterHiRes();
+
+                    {
+                        Graphics g(image);
+                        g.addTransform(AffineTransform::scale(scale));
+                        editor->paintEntireComponent(g, false);
+                    }
+
+                    paintMs[(size_t)frame] = Time::getMillisecondCounterHiRes() - start;
+                    worstPaintMs = jmax(worstPaintMs, paintMs[(size_t)frame]);
+                }
+
+                const auto totalPaintMs = std::accumulate(paintMs.begin(), paintMs.end(), 0.);
+                std::nth_element(paintMs.begin(), paintMs.begin() + numFrames / 2, paintMs.end());
+
+                std::cout << width << ", "
+                          << height << ", "
+                          << (sweeps ? "on" : "off") << ", "
+                          << 1000. * layoutMs / numFrames << ", "
+                          << 1000. * updateMs / numFrames << ", "
+                          << totalPaintMs / numFrames << ", "
+                          << worstPaintMs << ", "
+                          << paintMs[(size_t)numFrames / 2] << std::endl;
+            }
+        }
+
+        editor = nullptr;
+        processor.releaseResources();
+    }
+
+    //==============================================================================
+    void addCommands(ConsoleApplication& app) {
+        app.addHelpCommand("--help|-h", "Pantheon Stereo Shaper", false);
+
+        app.addCommand({"--streams",
+                        "--streams [files...] [--loopback=N] [--seconds=S] [--rate=R] [--threads=N] [--block=N] [--out=dir]",
+                        "Runs one Pantheon engine per input stream across a work-stealing pool.",
+                        "Each file, or each generated loopback stand-in, gets its own engine and parameter state. "
+                        "Prints per-stream latency and the overall throughput.",
+                        runStreams});
+
+        app.addCommand({"--host-sim",
+                        "--host-sim [script] [--seed=N] [--jump=X]",
+                        "Replays scripted host behaviour: rate switches, resets, uneven blocks, automation storms.",
+                        "Without a script file a built-in one is used; see HostSimulator.h for the format. "
+                        "Reports per step the prepare time, call latency and output jumps larger than --jump "
+                        "on a steady 220 Hz sine.",
+                        runHostSimulation});
+
+        app.addCommand({"--memory",
+                        "--memory [--rate=R] [--block=N]",
+                        "Prints the per-instance audio-thread memory, per stage and layout.",
+                        "Prepares one instance per supported layout and reports its arena, broken down by stage.",
+                        printMemoryFootprint});
+
+        app.addCommand({"--instances",
+                        "--instances=N [--rate=R] [--block=N]",
+                        "Creates and prepares N instances side by side and prints what each one costs.",
+                        "Reports the arena, heap and startup time of the first instance and the average of the rest, "
+                        "which find the coefficient tables and FFTs already built, and how many of those are live. "
+                        "Heap use is read from the allocator on Linux and macOS only.",
+                        runInstanceBenchmark});
+
+        app.addCommand({"--state-bench",
+                        "--state-bench [--instances=N] [--rate=R] [--block=N]",
+                        "Times a session's worth of state restores, synchronous against through StateRestorer.",
+                        "Restores N prepared instances from a random state each: parsing and replacing the "
+                        "ValueTree in place as setStateInformation used to, then through setStateInformation alone, "
+                        "which is what the loading thread waits for, then through setStateInformation with the "
+                        "decode and apply done straight away, which is the whole of the new path's work.",
+                        runStateBenchmark});
+
+        app.addCommand({"--spectral-bench",
+                        "--spectral-bench [--seconds=S] [--rate=R] [--block=N]",
+                        "Times the spectral mode at each overlap against the time-domain chain.",
+                        "Renders the same noise through one instance per setup and reports the processBlock time.",
+                        runSpectralBenchmark});
+
+        app.addCommand({"--render-chunked",
+                        "--render-chunked file [--out=file] [--verify] [--chunk=S] [--threads=N] [--block=N] [--tolerance=X] [--params=id:value,...]",
+                        "Renders one long file in parallel chunks, each pre-rolled over a measured warm-up.",
+                        "--verify also renders the file through a single instance and fails if any sample "
+                        "differs by more than --tolerance, or if any instance left full quality; it holds both "
+                        "renders in memory.",
+                        runChunkedRender});
+
+        app.addCommand({"--grid",
+                        "--grid file --axes=\"id=a,b,c;id=from:to:count\"|axes.txt --out=dir [--metrics-only] [--params=id:value,...] [--threads=N] [--block=N]",
+                        "Renders the file once per combination of a parameter grid, in parallel.",
+                        "Each axis is a parameter ID with a list of plain values or an evenly spaced range; "
+                        "every combination is rendered on its own freshly prepared engine. Writes the renders "
+                        "and index.csv, with each render's values, RMS, peak and L/R correlation, to --out.",
+                        runGridRender});
+
+        app.addCommand({"--dsp-bench",
+                        "--dsp-bench [--seconds=S] [--rate=R] [--block=N] [--params=id:value,...]",
+                        "Times the C API in PantheonDsp.h against the plugin's processBlock.",
+                        "Runs the same noise through both at every power-of-two block size from 16 up to --block, "
+                        "planar and interleaved, and reports the time per call.",
+                        runDspBenchmark});
+
+        app.addCommand({"--warmup-bench",
+                        "--warmup-bench [--trials=N] [--rate=R] [--block=N] [--lock] [--params=id:value,...]",
+                        "Times the first block after prepare against steady state, with and without the warm-up.",
+                        "Prepares a fresh stereo engine per trial, then times its first block and the median of "
+                        "the 64 after it. --lock also locks the engine's memory into RAM.",
+                        runWarmUpBenchmark});
+
+        app.addCommand({"--delay-bench",
+                        "--delay-bench [--seconds=S] [--rate=R] [--block=N]",
+                        "Times each fractional-delay interpolator, fixed and swept, in ns per sample.",
+                        "Runs noise through a stereo delay at a fixed fractional delay and along a per-sample "
+                        "sweep, against the linear interpolator at a fixed delay.",
+                        runDelayBenchmark});
+
+        app.addCommand({"--kernel-check",
+                        "--kernel-check [--trials=N] [--tolerance=X]",
+                        "Checks every SIMD kernel variant this CPU can run against the generic one.",
+                        "Switches each variant in through kernels::setOverride and runs all four kernels on random "
+                        "data at every length up to 63 and random ones up to 1027, from unaligned offsets. Fails if "
+                        "any output differs from the generic variant's by more than --tolerance.",
+                        runKernelCheck});
+
+        app.addCommand({"--allpass-bench",
+                        "--allpass-bench [--seconds=S] [--rate=R] [--block=N]",
+                        "Times the allpass bank at 2, 4, 8 and 16 stages against the old two-stage filter chain, in ns per sample.",
+                        "Runs noise through both channels at a 1 kHz cutoff: the bank with its stages spread an octave "
+                        "each side, the chain as two juce::dsp::FirstOrderTPTFilter allpasses per channel, as the "
+                        "Phase control used before the bank.",
+                        runAllPassBenchmark});
+
+        app.addCommand({"--gui-bench",
+                        "--gui-bench [--frames=N] [--sizes=w,w,...] [--scale=S] [--params=id:value,...]",
+                        "Times laying out and painting the editor offscreen, per frame, at widths from 200 to 1080 px.",
+                        "Renders the editor into an Image at each width, --scale times the pixels, first with the "
+                        "parameters still and then with every parameter sweeping its range. The response curve's "
+                        "timer doesn't run here; the sweep recomputes the curve every frame instead, counted in the "
+                        "update time.",
+                        runGuiBenchmark});
+    }
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Command-line modes of the standalone app. Any of these on the command line
+// runs headless instead of opening the plugin window.
+namespace headless {
+    void addCommands(ConsoleApplication&);
+}
@@ -0,0 +1,224 @@
+#include <JuceHeader.h>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+//==============================================================================
+// Loads the built Pantheon VST3 the way a host does and times, per instance:
+// instantiation, prepareToPlay, steady-state processBlock, state save and
+// load, and editor creation; and for all of them, a session's worth of state
+// loads back to back. All instances stay alive together, as in a
+// session, and the results are printed as JSON.
+namespace {
+    struct Timings {
+        double instantiateMs { 0. };
+        double prepareMs { 0. };
+        double meanBlockUs { 0. };
+        double worstBlockUs { 0. };
+        double saveStateMs { 0. };
+        double loadStateMs { 0. };
+        int stateBytes { 0 };
+        double editorMs { -1. };
+    };
+
+    double msSince(double start) {
+        return Time::getMillisecondCounterHiRes() - start;
+    }
+
+    int getIntOption(const ArgumentList& args, const String& option, int defaultValue) {
+        const auto value = args.getValueForOption(option);
+        return value.isNotEmpty() ? value.getIntValue() : defaultValue;
+    }
+
+    PluginDescription findPlugin(const File& bundle) {
+        VST3PluginFormat format;
+        OwnedArray<PluginDescription> types;
+        format.findAllTypesForFile(types, bundle.getFullPathName());
+
+        if (types.isEmpty()) {
+            ConsoleApplication::fail("No VST3 plugin in " + bundle.getFullPathName());
+        }
+
+        return *types.getFirst();
+    }
+
+    var toJson(const Timings& t) {
+        auto* object = new DynamicObject();
+        object->setProperty("instantiateMs", t.instantiateMs);
+        object->setProperty("prepareMs", t.prepareMs);
+        object->setProperty("meanBlockUs", t.meanBlockUs);
+        object->setProperty("worstBlockUs", t.worstBlockUs);
+        object->setProperty("saveStateMs", t.saveStateMs);
+        object->setProperty("loadStateMs", t.loadStateMs);
+        object->setProperty("stateBytes", t.stateBytes);
+        object->setProperty("editorMs", t.editorMs);
+        return var(object);
+    }
+
+    //==============================================================================
+    void runBench(const ArgumentList& args) {
+       #ifdef PANTHEON_VST3_PATH
+        const File defaultBundle(PANTHEON_VST3_PATH);
+       #else
+        const File defaultBundle;
+       #endif
+
+        const auto bundle = args.containsOption("--plugin") ? args.getExistingFolderForOption("--plugin") : defaultBundle;
+        const auto numInstances = jmax(1, getIntOption(args, "--instances", 1));
+        const auto sampleRate = (double)getIntOption(args, "--rate", 48000);
+        const auto blockSize = getIntOption(args, "--block", 512);
+        const auto numBlocks = jmax(1, getIntOption(args, "--blocks", 2000));
+        const auto withEditor = ! args.containsOption("--no-editor");
+
+        AudioPluginFormatManager formatManager;
+        formatManager.addFormat(new VST3PluginFormat());
+
+        const auto description = findPlugin(bundle);
+
+        std::vector<std::unique_ptr<AudioPluginInstance>> instances;
+        std::vector<Timings> timings((size_t)numInstances);
+
+        for (auto& t : timings) {
+            String error;
+            const auto start = Time::getMillisecondCounterHiRes();
+            auto instance = formatManager.createPluginInstance(description, sampleRate, blockSize, error);
+            t.instantiateMs = msSince(start);
+
+            if (instance == nullptr) {
+                ConsoleApplication::fail("Can't instantiate: " + error);
+            }
+
+            instances.push_back(std::move(instance));
+        }
+
+        for (size_t i = 0; i < instances.size(); ++i) {
+            auto& instance = *instances[i];
+            instance.enableAllBuses();
+
+            const auto start = Time::getMillisecondCounterHiRes();
+            instance.setRateAndBufferSizeDetails(sampleRate, blockSize);
+            instance.prepareToPlay(sampleRate, blockSize);
+            timings[i].prepareMs = msSince(start);
+        }
+
+        // round-robin across instances like a host's audio callback, after a warm-up
+        AudioBuffer<float> buffer(2, blockSize);
+        MidiBuffer midi;
+        Random random(1);
+        std::vector<double> totalUs(instances.size(), 0.);
+
+        for (int block = -numBlocks / 10; block < numBlocks; ++block) {
+            for (size_t i = 0; i < instances.size(); ++i) {
+                for (int ch = 0; ch < 2; ++ch) {
+                    for (int n = 0; n < blockSize; ++n) {
+                        buffer.setSample(ch, n, 0.25f * (2.f * random.nextFloat() - 1.f));
+                    }
+                }
+
+                const auto start = Time::getMillisecondCounterHiRes();
+                instances[i]->processBlock(buffer, midi);
+                const auto elapsedUs = 1000. * msSince(start);
+
+                if (block >= 0) {
+                    totalUs[i] += elapsedUs;
+                    timings[i].worstBlockUs = jmax(timings[i].worstBlockUs, elapsedUs);
+                }
+            }
+        }
+
+        std::vector<MemoryBlock> states(instances.size());
+
+        for (size_t i = 0; i < instances.size(); ++i) {
+            auto& t = timings[i];
+            t.meanBlockUs = totalUs[i] / numBlocks;
+
+            const auto start = Time::getMillisecondCounterHiRes();
+            instances[i]->getStateInformation(states[i]);
+            t.saveStateMs = msSince(start);
+            t.stateBytes = (int)states[i].getSize();
+        }
+
+        // a session load: every instance's state back to back, then the first
+        // block of each, which is where an asynchronous restore lands
+        const auto sessionStart = Time::getMillisecondCounterHiRes();
+
+        for (size_t i = 0; i < instances.size(); ++i) {
+            const auto start = Time::getMillisecondCounterHiRes();
+            instances[i]->setStateInformation(states[i].getData(), (int)states[i].getSize());
+            timings[i].loadStateMs = msSince(start);
+        }
+
+        const auto sessionLoadMs = msSince(sessionStart);
+        const auto blocksStart = Time::getMillisecondCounterHiRes();
+
+        for (auto& instance : instances) {
+            instance->processBlock(buffer, midi);
+        }
+
+        const auto blocksAfterLoadMs = msSince(blocksStart);
+
+        for (size_t i = 0; i < instances.size(); ++i) {
+            auto& instance = *instances[i];
+            auto& t = timings[i];
+
+            if (withEditor) {
+                const auto start = Time::getMillisecondCounterHiRes();
+                std::unique_ptr<AudioProcessorEditor> editor(instance.createEditorIfNeeded());
+                t.editorMs = msSince(start);
+
+                if (editor != nullptr) {
+                    instance.editorBeingDeleted(editor.get());
+                }
+            }
+        }
+
+        for (auto& instance : instances) {
+            instance->releaseResources();
+        }
+
+        // per instance, plus the totals a session load would see
+        auto* result = new DynamicObject();
+        result->setProperty("plugin", description.fileOrIdentifier);
+        result->setProperty("instances", numInstances);
+        result->setProperty("sampleRate", sampleRate);
+        result->setProperty("blockSize", blockSize);
+        result->setProperty("sessionLoadMs", sessionLoadMs);
+        result->setProperty("blocksAfterLoadMs", blocksAfterLoadMs);
+
+        Array<var> perInstance;
+        Timings total;
+
+        for (const auto& t : timings) {
+            perInstance.add(toJson(t));
+
+            total.instantiateMs += t.instantiateMs;
+            total.prepareMs += t.prepareMs;
+            total.meanBlockUs += t.meanBlockUs;
+            total.worstBlockUs = jmax(total.worstBlockUs, t.worstBlockUs);
+            total.saveStateMs += t.saveStateMs;
+            total.loadStateMs += t.loadStateMs;
+            total.stateBytes += t.stateBytes;
+            total.editorMs = withEditor ? jmax(0., total.editorMs) + t.editorMs : -1.;
+        }
+
+        result->setProperty("perInstance", perInstance);
+        result->setProperty("total", toJson(total));
+
+        std::cout << JSON::toString(var(result)) << std::endl;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+    ScopedJuceInitialiser_GUI juce;
+
+    ConsoleApplication app;
+    app.addHelpCommand("--help|-h", "Pantheon VST3 host bench", false);
+    app.addDefaultCommand({"",
+                           "[--plugin=bundle.vst3] [--instances=N] [--rate=R] [--block=N] [--blocks=N] [--no-editor]",
+                           "Loads the Pantheon VST3 N times and prints instantiate, prepare, process, state and editor timings as JSON.",
+                           "Without --plugin it loads the bundle built next to it.",
+                           runBench});
+
+    return app.findAndRunCommand(argc, argv);
+}
@@ -0,0 +1,227 @@
+#include "HostSimulator.h"
+
+namespace {
+    constexpr double testFrequency = 220.;
+    constexpr float testLevel = 0.5f;
+}
+
+//==============================================================================
+HostSimulator::HostSimulator(uint32 seed, float threshold)
+    : random((int64)seed)
+    , jumpThreshold(threshold)
+{
+}
+
+String HostSimulator::getDefaultScript() {
+    return "prepare 44100 512\n"
+           "process 200 512 512\n"
+           "process 500 1 512\n"
+           "storm 500 32 512\n"
+           "prepare 48000 256\n"
+           "storm 1000 1 256 fxPosition\n"
+           "storm 500 0 8 delayLine delayInterpolation\n"
+           "reset\n"
+           "process 200 1 256\n"
+           "prepare 96000 1024\n"
+           "storm 500 1 1024 inputGain inputPan leftPreGain rightPreGain leftToRightGain rightToLeftGain\n"
+           "prepare 192000 2048\n"
+           "storm 200 2048 2048\n"
+           "prepare 44100 64\n"
+           "storm 2000 1 64\n"
+           "reset\n"
+           "prepare 48000 480\n"
+           "process 500 480 480\n";
+}
+
+void HostSimulator::loadScript(const String& script) {
+    steps.clear();
+
+    for (auto line : StringArray::fromLines(script)) {
+        line = line.upToFirstOccurrenceOf("#", false, false).trim();
+
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        auto tokens = StringArray::fromTokens(line, false);
+        const auto command = tokens[0];
+
+        Step step;
+        step.description = line;
+
+        if (command == "prepare" && tokens.size() == 3) {
+            step.type = Step::Type::prepare;
+            step.sampleRate = tokens[1].getDoubleValue();
+            step.maxBlock = tokens[2].getIntValue();
+        } else if (command == "reset" && tokens.size() == 1) {
+            step.type = Step::Type::reset;
+        } else if ((command == "process" && tokens.size() == 4) || (command == "storm" && tokens.size() >= 4)) {
+            step.type = command == "process" ? Step::Type::process : Step::Type::storm;
+            step.calls = tokens[1].getIntValue();
+            step.minBlock = tokens[2].getIntValue();
+            step.maxBlock = tokens[3].getIntValue();
+
+            for (int i = 4; i < tokens.size(); ++i) {
+                step.parameterIDs.add(tokens[i]);
+            }
+        } else {
+            ConsoleApplication::fail("Bad script line: " + line);
+        }
+
+        if ((step.type == Step::Type::prepare && (step.sampleRate <= 0. || step.maxBlock <= 0))
+         || (step.calls < 0 || step.minBlock < 0 || step.maxBlock < step.minBlock)) {
+            ConsoleApplication::fail("Bad values in script line: " + line);
+        }
+
+        steps.push_back(step);
+    }
+
+    if (steps.empty() || steps.front().type != Step::Type::prepare) {
+        ConsoleApplication::fail("A script has to start with prepare");
+    }
+}
+
+//==============================================================================
+void HostSimulator::run() {
+    stats.clear();
+
+    for (const auto& step : steps) {
+        StepStats stepStats;
+        stepStats.description = step.description;
+
+        switch (step.type) {
+            case Step::Type::prepare:
+                prepare(step, stepStats);
+                break;
+
+            case Step::Type::reset: {
+                const auto start = Time::getMillisecondCounterHiRes();
+                processor.reset();
+                stepStats.prepareMs = Time::getMillisecondCounterHiRes() - start;
+                break;
+            }
+
+            case Step::Type::process:
+            case Step::Type::storm:
+                process(step, stepStats);
+                break;
+        }
+
+        stats.push_back(stepStats);
+    }
+
+    processor.releaseResources();
+}
+
+void HostSimulator::prepare(const Step& step, StepStats& stepStats) {
+    sampleRate = step.sampleRate;
+    maxBlock = step.maxBlock;
+
+    // some hosts skip releaseResources between prepares, so don't call it here
+    const auto start = Time::getMillisecondCounterHiRes();
+    processor.setRateAndBufferSizeDetails(sampleRate, maxBlock);
+    processor.prepareToPlay(sampleRate, maxBlock);
+    stepStats.prepareMs = Time::getMillisecondCounterHiRes() - start;
+
+    buffer.setSize(jmax(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels()), maxBlock);
+
+    // a rate switch restarts the stream; the first samples after it are not a jump
+    hasLastOutput = false;
+}
+
+void HostSimulator::process(const Step& step, StepStats& stepStats) {
+    const auto parameters = step.type == Step::Type::storm ? getParameters(step.parameterIDs)
+                                                            : Array<RangedAudioParameter*>();
+    const auto increment = MathConstants<double>::twoPi * testFrequency / sampleRate;
+
+    for (int call = 0; call < step.calls; ++call) {
+        const auto numSamples = jmin(maxBlock, step.minBlock + random.nextInt(step.maxBlock - step.minBlock + 1));
+
+        automate(parameters);
+
+        buffer.setSize(buffer.getNumChannels(), numSamples, false, false, true);
+
+        for (int i = 0; i < numSamples; ++i) {
+            const auto sample = testLevel * (float)std::sin(phase);
+            phase = std::fmod(phase + increment, MathConstants<double>::twoPi);
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+                buffer.setSample(ch, i, sample);
+            }
+        }
+
+        const auto start = Time::getMillisecondCounterHiRes();
+        processor.processBlock(buffer, midi);
+        const auto elapsed = Time::getMillisecondCounterHiRes() - start;
+
+        stepStats.calls += 1;
+        stepStats.samples += numSamples;
+        stepStats.totalCallMs += elapsed;
+
+        if (elapsed > stepStats.worstCallMs) {
+            stepStats.worstCallMs = elapsed;
+            stepStats.worstCallSize = numSamples;
+        }
+
+        checkOutput(numSamples, stepStats);
+    }
+}
+
+void HostSimulator::automate(const Array<RangedAudioParameter*>& parameters) {
+    for (auto* parameter : parameters) {
+        parameter->beginChangeGesture();
+        parameter->setValueNotifyingHost(random.nextFloat());
+        parameter->endChangeGesture();
+    }
+}
+
+void HostSimulator::checkOutput(int numSamples, StepStats& stepStats) {
+    if (numSamples == 0) {
+        return;
+    }
+
+    for (int ch = 0; ch < jmin(2, buffer.getNumChannels()); ++ch) {
+        const auto* samples = buffer.getReadPointer(ch);
+        auto previous = hasLastOutput ? lastOutput[ch] : samples[0];
+
+        for (int i = 0; i < numSamples; ++i) {
+            const auto jump = std::abs(samples[i] - previous);
+
+            if (jump > jumpThreshold) {
+                stepStats.discontinuities += 1;
+            }
+
+            stepStats.worstJump = jmax(stepStats.worstJump, jump);
+            previous = samples[i];
+        }
+
+        lastOutput[ch] = previous;
+    }
+
+    hasLastOutput = true;
+}
+
+Array<RangedAudioParameter*> HostSimulator::getParameters(const StringArray& ids) const {
+    Array<RangedAudioParameter*> parameters;
+
+    for (auto* parameter : processor.getParameters()) {
+        auto* ranged = dynamic_cast<RangedAudioParameter*>(parameter);
+
+        if (ranged == nullptr) {
+            continue;
+        }
+
+        const auto isWanted = ids.isEmpty() ? dynamic_cast<AudioParameterChoice*>(ranged) == nullptr
+                                            : ids.contains(ranged->getParameterID());
+
+        if (isWanted) {
+            parameters.add(ranged);
+        }
+    }
+
+    if (parameters.size() < ids.size()) {
+        ConsoleApplication::fail("Unknown parameter in: " + ids.joinIntoString(" "));
+    }
+
+    return parameters;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+#include "PluginProcessor.h"
+
+//==============================================================================
+// Replays scripted host behaviour against a plugin instance: sample rate
+// switches, resets, uneven block sizes and dense automation. Times every call
+// and watches the output of a steady sine for jumps.
+//
+// Script lines, one step each ('#' starts a comment):
+//   prepare <rate> <maxBlock>
+//   reset
+//   process <calls> <minBlock> <maxBlock>
+//   storm <calls> <minBlock> <maxBlock> [parameterIDs...]
+// A storm moves its parameters (all but the choices by default) to random
+// values before every call.
+class HostSimulator {
+public:
+    struct StepStats {
+        String description;
+        int calls { 0 };
+        int64 samples { 0 };
+        double prepareMs { 0. };
+        double totalCallMs { 0. };
+        double worstCallMs { 0. };
+        int worstCallSize { 0 };
+        int discontinuities { 0 };
+        float worstJump { 0.f };
+    };
+
+    HostSimulator(uint32 seed, float jumpThreshold);
+
+    // fails through ConsoleApplication::fail() on a bad line
+    void loadScript(const String& script);
+    static String getDefaultScript();
+
+    void run();
+
+    const std::vector<StepStats>& getStats() const noexcept { return stats; }
+
+private:
+    //==============================================================================
+    struct Step {
+        enum class Type { prepare, reset, process, storm };
+
+        Type type;
+        double sampleRate { 0. };
+        int calls { 0 }, minBlock { 0 }, maxBlock { 0 };
+        StringArray parameterIDs;
+        String description;
+    };
+
+    void prepare(const Step&, StepStats&);
+    void process(const Step&, StepStats&);
+    void automate(const Array<RangedAudioParameter*>&);
+    void checkOutput(int numSamples, StepStats&);
+
+    Array<RangedAudioParameter*> getParameters(const StringArray& ids) const;
+
+    //==============================================================================
+    AudioPluginAudioProcessor processor;
+    MidiBuffer midi;
+    AudioBuffer<float> buffer;
+    Random random;
+
+    const float jumpThreshold;
+
+    double sampleRate { 0. };
+    int maxBlock { 0 };
+    double phase { 0. };
+    float lastOutput[2] {};
+    bool hasLastOutput { false };
+
+    std::vector<Step> steps;
+    std::vector<StepStats> stats;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HostSimulator)
+};
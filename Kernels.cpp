@@ -0,0 +1,325 @@
+#include "Kernels.h"
+
+#include <JuceHeader.h>
+#include <atomic>
+
+// Each ISA variant is compiled through a function target attribute instead of
+// per-file flags, so no shared inline code ever gets built for a wider ISA.
+#if JUCE_INTEL
+ #include <immintrin.h>
+
+ #if JUCE_MSVC
+  #define PANTHEON_TARGET(isa)
+ #else
+  #define PANTHEON_TARGET(isa) __attribute__((target (isa)))
+ #endif
+#endif
+
+namespace process {
+    namespace kernels {
+        //==============================================================================
+        namespace generic {
+            static void multiply(float* samples, float gain, int numSamples) noexcept {
+                for (int i = 0; i < numSamples; ++i) {
+                    samples[i] *= gain;
+                }
+            }
+
+            static void multiplyRamp(float* samples, float start, float step, int numSamples) noexcept {
+                for (int i = 0; i < numSamples; ++i) {
+                    samples[i] *= start + step * (float)(i + 1);
+                }
+            }
+
+            static void multiplyAdd(float* dest, const float* source, float gain, int numSamples) noexcept {
+                for (int i = 0; i < numSamples; ++i) {
+                    dest[i] += source[i] * gain;
+                }
+            }
+
+            static void multiplyAddRamp(float* dest, const float* source, float start, float step, int numSamples) noexcept {
+                for (int i = 0; i < numSamples; ++i) {
+                    dest[i] += source[i] * (start + step * (float)(i + 1));
+                }
+            }
+        }
+
+       #if JUCE_INTEL
+        //==============================================================================
+        namespace sse2 {
+            PANTHEON_TARGET("sse2")
+            static void multiply(float* samples, float gain, int numSamples) noexcept {
+                const auto g = _mm_set1_ps(gain);
+                int i = 0;
+
+                for (; i + 4 <= numSamples; i += 4) {
+                    _mm_storeu_ps(samples + i, _mm_mul_ps(_mm_loadu_ps(samples + i), g));
+                }
+
+                generic::multiply(samples + i, gain, numSamples - i);
+            }
+
+            PANTHEON_TARGET("sse2")
+            static void multiplyRamp(float* samples, float start, float step, int numSamples) noexcept {
+                const auto s0 = _mm_set1_ps(start);
+                const auto ds = _mm_set1_ps(step);
+                const auto offsets = _mm_set_ps(4.f, 3.f, 2.f, 1.f);
+                int i = 0;
+
+                for (; i + 4 <= numSamples; i += 4) {
+                    const auto g = _mm_add_ps(s0, _mm_mul_ps(ds, _mm_add_ps(_mm_set1_ps((float)i), offsets)));
+                    _mm_storeu_ps(samples + i, _mm_mul_ps(_mm_loadu_ps(samples + i), g));
+                }
+
+                for (; i < numSamples; ++i) {
+                    samples[i] *= start + step * (float)(i + 1);
+                }
+            }
+
+            PANTHEON_TARGET("sse2")
+            static void multiplyAdd(float* dest, const float* source, float gain, int numSamples) noexcept {
+                const auto g = _mm_set1_ps(gain);
+                int i = 0;
+
+                for (; i + 4 <= numSamples; i += 4) {
+                    const auto product = _mm_mul_ps(_mm_loadu_ps(source + i), g);
+                    _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), product));
+                }
+
+                generic::multiplyAdd(dest + i, source + i, gain, numSamples - i);
+            }
+
+            PANTHEON_TARGET("sse2")
+            static void multiplyAddRamp(float* dest, const float* source, float start, float step, int numSamples) noexcept {
+                const auto s0 = _mm_set1_ps(start);
+                const auto ds = _mm_set1_ps(step);
+                const auto offsets = _mm_set_ps(4.f, 3.f, 2.f, 1.f);
+                int i = 0;
+
+                for (; i + 4 <= numSamples; i += 4) {
+                    const auto g = _mm_add_ps(s0, _mm_mul_ps(ds, _mm_add_ps(_mm_set1_ps((float)i), offsets)));
+                    const auto product = _mm_mul_ps(_mm_loadu_ps(source + i), g);
+                    _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), product));
+                }
+
+                for (; i < numSamples; ++i) {
+                    dest[i] += source[i] * (start + step * (float)(i + 1));
+                }
+            }
+        }
+
+        //==============================================================================
+        namespace avx2 {
+            PANTHEON_TARGET("avx2,fma")
+            static void multiply(float* samples, float gain, int numSamples) noexcept {
+                const auto g = _mm256_set1_ps(gain);
+                int i = 0;
+
+                for (; i + 8 <= numSamples; i += 8) {
+                    _mm256_storeu_ps(samples + i, _mm256_mul_ps(_mm256_loadu_ps(samples + i), g));
+                }
+
+                sse2::multiply(samples + i, gain, numSamples - i);
+            }
+
+            PANTHEON_TARGET("avx2,fma")
+            static void multiplyRamp(float* samples, float start, float step, int numSamples) noexcept {
+                const auto s0 = _mm256_set1_ps(start);
+                const auto ds = _mm256_set1_ps(step);
+                const auto offsets = _mm256_set_ps(8.f, 7.f, 6.f, 5.f, 4.f, 3.f, 2.f, 1.f);
+                int i = 0;
+
+                for (; i + 8 <= numSamples; i += 8) {
+                    const auto g = _mm256_fmadd_ps(ds, _mm256_add_ps(_mm256_set1_ps((float)i), offsets), s0);
+                    _mm256_storeu_ps(samples + i, _mm256_mul_ps(_mm256_loadu_ps(samples + i), g));
+                }
+
+                for (; i < numSamples; ++i) {
+                    samples[i] *= start + step * (float)(i + 1);
+                }
+            }
+
+            PANTHEON_TARGET("avx2,fma")
+            static void multiplyAdd(float* dest, const float* source, float gain, int numSamples) noexcept {
+                const auto g = _mm256_set1_ps(gain);
+                int i = 0;
+
+                for (; i + 8 <= numSamples; i += 8) {
+                    _mm256_storeu_ps(dest + i, _mm256_fmadd_ps(_mm256_loadu_ps(source + i), g, _mm256_loadu_ps(dest + i)));
+                }
+
+                sse2::multiplyAdd(dest + i, source + i, gain, numSamples - i);
+            }
+
+            PANTHEON_TARGET("avx2,fma")
+            static void multiplyAddRamp(float* dest, const float* source, float start, float step, int numSamples) noexcept {
+                const auto s0 = _mm256_set1_ps(start);
+                const auto ds = _mm256_set1_ps(step);
+                const auto offsets = _mm256_set_ps(8.f, 7.f, 6.f, 5.f, 4.f, 3.f, 2.f, 1.f);
+                int i = 0;
+
+                for (; i + 8 <= numSamples; i += 8) {
+                    const auto g = _mm256_fmadd_ps(ds, _mm256_add_ps(_mm256_set1_ps((float)i), offsets), s0);
+                    _mm256_storeu_ps(dest + i, _mm256_fmadd_ps(_mm256_loadu_ps(source + i), g, _mm256_loadu_ps(dest + i)));
+                }
+
+                for (; i < numSamples; ++i) {
+                    dest[i] += source[i] * (start + step * (float)(i + 1));
+                }
+            }
+        }
+
+        //==============================================================================
+        namespace avx512 {
+            PANTHEON_TARGET("avx512f")
+            static __mmask16 getTailMask(int remaining) noexcept {
+                return (__mmask16)((1u << remaining) - 1u);
+            }
+
+            PANTHEON_TARGET("avx512f")
+            static void multiply(float* samples, float gain, int numSamples) noexcept {
+                const auto g = _mm512_set1_ps(gain);
+                int i = 0;
+
+                for (; i + 16 <= numSamples; i += 16) {
+                    _mm512_storeu_ps(samples + i, _mm512_mul_ps(_mm512_loadu_ps(samples + i), g));
+                }
+
+                if (i < numSamples) {
+                    const auto mask = getTailMask(numSamples - i);
+                    _mm512_mask_storeu_ps(samples + i, mask, _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, samples + i), g));
+                }
+            }
+
+            PANTHEON_TARGET("avx512f")
+            static void multiplyRamp(float* samples, float start, float step, int numSamples) noexcept {
+                const auto s0 = _mm512_set1_ps(start);
+                const auto ds = _mm512_set1_ps(step);
+                const auto offsets = _mm512_set_ps(16.f, 15.f, 14.f, 13.f, 12.f, 11.f, 10.f, 9.f,
+                                                   8.f, 7.f, 6.f, 5.f, 4.f, 3.f, 2.f, 1.f);
+
+                for (int i = 0; i < numSamples; i += 16) {
+                    const auto mask = getTailMask(numSamples - i < 16 ? numSamples - i : 16);
+                    const auto g = _mm512_fmadd_ps(ds, _mm512_add_ps(_mm512_set1_ps((float)i), offsets), s0);
+                    _mm512_mask_storeu_ps(samples + i, mask, _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, samples + i), g));
+                }
+            }
+
+            PANTHEON_TARGET("avx512f")
+            static void multiplyAdd(float* dest, const float* source, float gain, int numSamples) noexcept {
+                const auto g = _mm512_set1_ps(gain);
+
+                for (int i = 0; i < numSamples; i += 16) {
+                    const auto mask = getTailMask(numSamples - i < 16 ? numSamples - i : 16);
+                    const auto sum = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, source + i), g, _mm512_maskz_loadu_ps(mask, dest + i));
+                    _mm512_mask_storeu_ps(dest + i, mask, sum);
+                }
+            }
+
+            PANTHEON_TARGET("avx512f")
+            static void multiplyAddRamp(float* dest, const float* source, float start, float step, int numSamples) noexcept {
+                const auto s0 = _mm512_set1_ps(start);
+                const auto ds = _mm512_set1_ps(step);
+                const auto offsets = _mm512_set_ps(16.f, 15.f, 14.f, 13.f, 12.f, 11.f, 10.f, 9.f,
+                                                   8.f, 7.f, 6.f, 5.f, 4.f, 3.f, 2.f, 1.f);
+
+                for (int i = 0; i < numSamples; i += 16) {
+                    const auto mask = getTailMask(numSamples - i < 16 ? numSamples - i : 16);
+                    const auto g = _mm512_fmadd_ps(ds, _mm512_add_ps(_mm512_set1_ps((float)i), offsets), s0);
+                    const auto sum = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, source + i), g, _mm512_maskz_loadu_ps(mask, dest + i));
+                    _mm512_mask_storeu_ps(dest + i, mask, sum);
+                }
+            }
+        }
+       #endif
+
+        //==============================================================================
+        static const KernelTable genericTable {
+            Isa::Generic, "generic",
+            generic::multiply, generic::multiplyRamp, generic::multiplyAdd, generic::multiplyAddRamp
+        };
+
+       #if JUCE_INTEL
+        static const KernelTable sse2Table {
+            Isa::SSE2, "sse2",
+            sse2::multiply, sse2::multiplyRamp, sse2::multiplyAdd, sse2::multiplyAddRamp
+        };
+
+        static const KernelTable avx2Table {
+            Isa::AVX2, "avx2",
+            avx2::multiply, avx2::multiplyRamp, avx2::multiplyAdd, avx2::multiplyAddRamp
+        };
+
+        static const KernelTable avx512Table {
+            Isa::AVX512, "avx512",
+            avx512::multiply, avx512::multiplyRamp, avx512::multiplyAdd, avx512::multiplyAddRamp
+        };
+       #endif
+
+        //==============================================================================
+        const KernelTable* getTable(Isa isa) noexcept {
+            switch (isa) {
+                case Isa::Generic:
+                    return &genericTable;
+
+               #if JUCE_INTEL
+                case Isa::SSE2:
+                    return SystemStats::hasSSE2() ? &sse2Table : nullptr;
+
+                case Isa::AVX2:
+                    return SystemStats::hasAVX2() && SystemStats::hasFMA3() ? &avx2Table : nullptr;
+
+                case Isa::AVX512:
+                    return SystemStats::hasAVX512F() ? &avx512Table : nullptr;
+               #endif
+
+                default:
+                    break;
+            }
+
+            return nullptr;
+        }
+
+        static Isa getIsaCap() {
+            const auto cap = SystemStats::getEnvironmentVariable("PANTHEON_ISA", {}).trim().toLowerCase();
+
+            if (cap == "generic") return Isa::Generic;
+            if (cap == "sse2")    return Isa::SSE2;
+            if (cap == "avx2")    return Isa::AVX2;
+
+            return Isa::AVX512;
+        }
+
+        static const KernelTable* selectBest() {
+            const auto cap = getIsaCap();
+
+            for (const auto isa : {Isa::AVX512, Isa::AVX2, Isa::SSE2}) {
+                if (isa <= cap) {
+                    if (const auto* table = getTable(isa)) {
+                        return table;
+                    }
+                }
+            }
+
+            return &genericTable;
+        }
+
+        static std::atomic<const KernelTable*>& getActive() noexcept {
+            static std::atomic<const KernelTable*> active { selectBest() };
+            return active;
+        }
+
+        const KernelTable& get() noexcept {
+            return *getActive().load(std::memory_order_relaxed);
+        }
+
+        bool setOverride(Isa isa) noexcept {
+            if (const auto* table = getTable(isa)) {
+                getActive().store(table);
+                return true;
+            }
+
+            return false;
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+namespace process {
+    namespace kernels {
+        //==============================================================================
+        enum class Isa {
+            Generic = 0,
+            SSE2,
+            AVX2,
+            AVX512,
+        };
+
+        // Ramped gains follow LinearSmoothedValue: sample i is scaled by start + step * (i + 1).
+        //
+        // NOTE: the allpass and delay loops aren't dispatched. The allpass bank
+        // carries L and R as the two lanes of one SIMDRegister, so a wider ISA
+        // has no more lanes to fill. The delay's cost is reading each tap from
+        // the ring at its own position, a gather SSE2 doesn't have and AVX2's
+        // doesn't beat scalar loads at; the tap arithmetic around it already
+        // runs in StereoDelay's structure-of-arrays chunks, vectorised at the
+        // build's baseline ISA. --kernel-check compares the variants below.
+        struct KernelTable {
+            Isa isa;
+            const char* name;
+
+            void (*multiply)(float* samples, float gain, int numSamples) noexcept;
+            void (*multiplyRamp)(float* samples, float start, float step, int numSamples) noexcept;
+            void (*multiplyAdd)(float* dest, const float* source, float gain, int numSamples) noexcept;
+            void (*multiplyAddRamp)(float* dest, const float* source, float start, float step, int numSamples) noexcept;
+        };
+
+        //==============================================================================
+        // Best table for this CPU, picked from CPUID on first use. Setting the
+        // PANTHEON_ISA environment variable to generic, sse2, avx2 or avx512 caps it.
+        const KernelTable& get() noexcept;
+
+        // Table for a given ISA, or nullptr when this build or CPU can't run it.
+        const KernelTable* getTable(Isa) noexcept;
+
+        // Forces the active table, e.g. to compare variants. Returns false if unavailable.
+        bool setOverride(Isa) noexcept;
+    }
+}
@@ -0,0 +1,63 @@
+#include "LoadGovernor.h"
+#include <cmath>
+
+namespace process {
+    //==============================================================================
+    void LoadGovernor::prepare(double newSampleRate) noexcept {
+        sampleRate = newSampleRate;
+        reset();
+    }
+
+    void LoadGovernor::reset() noexcept {
+        smoothedLoad = 0.;
+        secondsAbove = secondsBelow = 0.;
+        load.store(0.f, std::memory_order_relaxed);
+    }
+
+    void LoadGovernor::setEnabled(bool shouldBeEnabled) noexcept {
+        enabled.store(shouldBeEnabled, std::memory_order_relaxed);
+    }
+
+    bool LoadGovernor::update(int64 elapsedTicks, int numSamples) noexcept {
+        if (! isEnabled()) {
+            return setLevel((int)Quality::Full);
+        }
+
+        if (numSamples <= 0) {
+            return false;
+        }
+
+        const auto blockSeconds = (double)numSamples / sampleRate;
+        const auto blockLoad = (double)elapsedTicks * secondsPerTick / blockSeconds;
+
+        // one-pole over time, not over blocks, so the block size doesn't change it
+        smoothedLoad += (1. - std::exp(-blockSeconds / smoothingSeconds)) * (blockLoad - smoothedLoad);
+        load.store((float)smoothedLoad, std::memory_order_relaxed);
+
+        secondsAbove = smoothedLoad > stepDownLoad ? secondsAbove + blockSeconds : 0.;
+        secondsBelow = smoothedLoad < stepUpLoad ? secondsBelow + blockSeconds : 0.;
+
+        const auto current = level.load(std::memory_order_relaxed);
+
+        if (secondsAbove >= stepDownSeconds && current < (int)Quality::Economy) {
+            secondsAbove = 0.;
+            return setLevel(current + 1);
+        }
+
+        if (secondsBelow >= stepUpSeconds && current > (int)Quality::Full) {
+            secondsBelow = 0.;
+            return setLevel(current - 1);
+        }
+
+        return false;
+    }
+
+    bool LoadGovernor::setLevel(int newLevel) noexcept {
+        if (level.exchange(newLevel, std::memory_order_relaxed) == newLevel) {
+            return false;
+        }
+
+        numTransitions.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+namespace process {
+    //==============================================================================
+    // How much the stages may trade away to stay within the realtime budget.
+    enum class Quality {
+        Full = 0,
+        Reduced,        // whole-sample delays, Fx coefficients every few blocks, spectral overlap of 4 at most
+        Economy,        // as Reduced, spectral overlap of 2, and Pre/mixer gains within -60 dB of identity fold to it
+    };
+
+    //==============================================================================
+    // Picks a Quality from how long each block took against its realtime budget.
+    // The load is smoothed over blocks, and it takes sustained load above
+    // stepDownLoad to step down one level but a longer stretch below stepUpLoad
+    // to step back up, so a single slow block or a load hovering near one
+    // threshold doesn't make it flap.
+    class LoadGovernor {
+    public:
+        // fractions of the block's duration spent processing it
+        static constexpr float stepDownLoad = 0.7f;
+        static constexpr float stepUpLoad = 0.35f;
+
+        static constexpr double smoothingSeconds = 0.1;
+        static constexpr double stepDownSeconds = 0.25;
+        static constexpr double stepUpSeconds = 2.;
+
+        LoadGovernor() = default;
+
+        void prepare(double sampleRate) noexcept;
+        void reset() noexcept;
+
+        // off means Full from the next update on, e.g. for offline rendering
+        void setEnabled(bool) noexcept;
+        bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+
+        // after each block; true when the level changed
+        bool update(int64 elapsedTicks, int numSamples) noexcept;
+
+        // readable from any thread
+        Quality getQuality() const noexcept { return (Quality)level.load(std::memory_order_relaxed); }
+        int getNumTransitions() const noexcept { return numTransitions.load(std::memory_order_relaxed); }
+        float getLoad() const noexcept { return load.load(std::memory_order_relaxed); }
+
+    private:
+        //==============================================================================
+        bool setLevel(int newLevel) noexcept;
+
+        //==============================================================================
+        double sampleRate { 44100. };
+        double secondsPerTick { 1. / (double)Time::getHighResolutionTicksPerSecond() };
+
+        double smoothedLoad { 0. };
+        double secondsAbove { 0. };
+        double secondsBelow { 0. };
+
+        std::atomic<bool> enabled { false };
+        std::atomic<int> level { (int)Quality::Full };
+        std::atomic<int> numTransitions { 0 };
+        std::atomic<float> load { 0.f };
+
+        //==============================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoadGovernor)
+    };
+}
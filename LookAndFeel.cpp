@@ -18,6 +18,13 @@ PanLook::PanLook(Origin origin, bool reversed)
 {
 }
 
+PanLooks::PanLooks()
+{
+    title.setColour(GroupComponent::outlineColourId, Colours::linen);
+    title.setColour(GroupComponent::textColourId, Colours::linen);
+    title.textH = 20.f;
+}
+
 Colour PanLook::leftColour = Colours::goldenrod;
 Colour PanLook::rightColour = Colours::indianred;
 Colour PanLook::thumbColour = Colours::bisque;
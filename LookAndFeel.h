@@ -36,4 +36,19 @@ private:
     Origin sliderOrigin;
     Channel sliderChannel;
     bool isReversed;
+};
+
+//==============================================================================
+// Every PanLook variant the editor uses. Held through a SharedResourcePointer,
+// so all editors in the host process draw with one set.
+struct PanLooks {
+    PanLooks();
+
+    PanLook title;
+    PanLook fromMid { PanLook::Origin::FromMid };
+    PanLook fromMin { PanLook::Origin::FromMin };
+    PanLook leftFromMid { PanLook::Origin::FromMid, PanLook::Channel::Left };
+    PanLook rightFromMid { PanLook::Origin::FromMid, PanLook::Channel::Right };
+
+    JUCE_DECLARE_NON_COPYABLE (PanLooks)
 };
\ No newline at end of file
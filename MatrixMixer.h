@@ -0,0 +1,194 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <utility>
+#include <vector>
+
+#include "Arena.h"
+#include "Kernels.h"
+
+namespace process {
+    //==============================================================================
+    // Left/right channel index pairs of a layout: L/R, surrounds, sides, rears, heights.
+    inline std::vector<std::pair<int, int>> getChannelPairs(const AudioChannelSet& layout) {
+        using Type = AudioChannelSet::ChannelType;
+
+        static constexpr std::pair<Type, Type> pairTypes[] = {
+            {AudioChannelSet::left, AudioChannelSet::right},
+            {AudioChannelSet::wideLeft, AudioChannelSet::wideRight},
+            {AudioChannelSet::leftSurround, AudioChannelSet::rightSurround},
+            {AudioChannelSet::leftSurroundSide, AudioChannelSet::rightSurroundSide},
+            {AudioChannelSet::leftSurroundRear, AudioChannelSet::rightSurroundRear},
+            {AudioChannelSet::topFrontLeft, AudioChannelSet::topFrontRight},
+            {AudioChannelSet::topRearLeft, AudioChannelSet::topRearRight},
+        };
+
+        std::vector<std::pair<int, int>> pairs;
+
+        for (const auto& types : pairTypes) {
+            const auto left = layout.getChannelIndexForType(types.first);
+            const auto right = layout.getChannelIndexForType(types.second);
+
+            if (left >= 0 && right >= 0) {
+                pairs.emplace_back(left, right);
+            }
+        }
+
+        return pairs;
+    }
+
+    //==============================================================================
+    class MatrixMixerBase {
+    public:
+        virtual ~MatrixMixerBase() = default;
+
+        // takes the scratch for one chunk of every input from the arena
+        virtual void prepare(Arena&, int maximumBlockSize) = 0;
+        virtual void reset() noexcept = 0;
+
+        // gains ramp linearly over the next processed block
+        virtual void setGain(int input, int output, float gain) noexcept = 0;
+        virtual float getGain(int input, int output) const noexcept = 0;
+
+        // true until a block has run the ramp towards the last gains set
+        virtual bool isRamping() const noexcept = 0;
+
+        virtual void process(AudioBuffer<float>&) noexcept = 0;
+    };
+
+    //==============================================================================
+    // NumInputs x NumOutputs gain matrix. Each non-zero path is one vectorised
+    // multiply-accumulate across the block; paths that are and stay at zero are
+    // skipped entirely.
+    template <int NumInputs, int NumOutputs>
+    class MatrixMixer : public MatrixMixerBase {
+    public:
+        MatrixMixer() = default;
+
+        static size_t getArenaBytes(int maximumBlockSize) noexcept {
+            return Arena::sizeFor<MatrixMixer>() + NumInputs * Arena::sizeFor<float>((size_t)jmax(1, maximumBlockSize));
+        }
+
+        void prepare(Arena& arena, int maximumBlockSize) override {
+            chunkSize = jmax(1, maximumBlockSize);
+
+            for (auto& channel : scratch) {
+                channel = arena.take<float>((size_t)chunkSize);
+            }
+
+            reset();
+        }
+
+        void reset() noexcept override {
+            for (int o = 0; o < NumOutputs; ++o) {
+                for (int i = 0; i < NumInputs; ++i) {
+                    current[o][i] = target[o][i];
+                }
+            }
+        }
+
+        void setGain(int input, int output, float gain) noexcept override {
+            jassert(isPositiveAndBelow(input, NumInputs) && isPositiveAndBelow(output, NumOutputs));
+            target[output][input] = gain;
+        }
+
+        float getGain(int input, int output) const noexcept override {
+            jassert(isPositiveAndBelow(input, NumInputs) && isPositiveAndBelow(output, NumOutputs));
+            return target[output][input];
+        }
+
+        bool isRamping() const noexcept override {
+            for (int o = 0; o < NumOutputs; ++o) {
+                for (int i = 0; i < NumInputs; ++i) {
+                    if (current[o][i] != target[o][i]) {
+                        return true;
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        void process(AudioBuffer<float>& buffer) noexcept override {
+            jassert(buffer.getNumChannels() >= jmax(NumInputs, NumOutputs));
+
+            const auto numSamples = buffer.getNumSamples();
+
+            for (int start = 0; start < numSamples; start += chunkSize) {
+                processChunk(buffer, start, jmin(chunkSize, numSamples - start));
+            }
+        }
+
+    private:
+        //==============================================================================
+        void processChunk(AudioBuffer<float>& buffer, int start, int numSamples) noexcept {
+            for (int i = 0; i < NumInputs; ++i) {
+                FloatVectorOperations::copy(scratch[i], buffer.getReadPointer(i, start), numSamples);
+            }
+
+            const auto& k = kernels::get();
+
+            for (int o = 0; o < NumOutputs; ++o) {
+                auto* out = buffer.getWritePointer(o, start);
+                FloatVectorOperations::clear(out, numSamples);
+
+                for (int i = 0; i < NumInputs; ++i) {
+                    const auto from = current[o][i];
+                    const auto to = target[o][i];
+
+                    if (from == 0.f && to == 0.f) {
+                        continue;
+                    }
+
+                    const auto* in = scratch[i];
+
+                    if (from == to) {
+                        k.multiplyAdd(out, in, to, numSamples);
+                    } else {
+                        k.multiplyAddRamp(out, in, from, (to - from) / (float)numSamples, numSamples);
+                        current[o][i] = to;
+                    }
+                }
+            }
+        }
+
+        //==============================================================================
+        float current[NumOutputs][NumInputs] {};
+        float target[NumOutputs][NumInputs] {};
+
+        float* scratch[NumInputs] {};
+        int chunkSize { 0 };
+
+        //==============================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MatrixMixer)
+    };
+
+    //==============================================================================
+    // square matrix for the supported layouts: stereo, 5.1, 7.1 and 7.1.4
+    inline size_t getMatrixMixerArenaBytes(int numChannels, int maximumBlockSize) noexcept {
+        switch (numChannels) {
+            case 2:  return MatrixMixer<2, 2>::getArenaBytes(maximumBlockSize);
+            case 6:  return MatrixMixer<6, 6>::getArenaBytes(maximumBlockSize);
+            case 8:  return MatrixMixer<8, 8>::getArenaBytes(maximumBlockSize);
+            case 12: return MatrixMixer<12, 12>::getArenaBytes(maximumBlockSize);
+            default: break;
+        }
+
+        jassertfalse;
+        return 0;
+    }
+
+    // the mixer lives in the arena and goes with its next allocate() or release()
+    inline MatrixMixerBase* createMatrixMixer(Arena& arena, int numChannels) {
+        switch (numChannels) {
+            case 2:  return arena.create<MatrixMixer<2, 2>>();
+            case 6:  return arena.create<MatrixMixer<6, 6>>();
+            case 8:  return arena.create<MatrixMixer<8, 8>>();
+            case 12: return arena.create<MatrixMixer<12, 12>>();
+            default: break;
+        }
+
+        jassertfalse;
+        return nullptr;
+    }
+}
@@ -4,27 +4,25 @@
 MixerComponent::MixerComponent(AudioPluginAudioProcessor& p, AudioProcessorValueTreeState& apvts)
     : processorRef(p)
     , parameters(apvts)
-    , leftPanLook(PanLook::Origin::FromMid, PanLook::Channel::Left)
-    , rightPanLook(PanLook::Origin::FromMid, PanLook::Channel::Right)
     , rightToLeftGainSlider(Slider::LinearVertical, Slider::NoTextBox)
     , leftPreGainSlider(Slider::LinearVertical, Slider::NoTextBox)
     , rightPreGainSlider(Slider::LinearVertical, Slider::NoTextBox)
     , leftToRightGainSlider(Slider::LinearVertical, Slider::NoTextBox)
 {
     addAndMakeVisible(rightToLeftGainSlider);
-    rightToLeftGainSlider.setLookAndFeel(&rightPanLook);
+    rightToLeftGainSlider.setLookAndFeel(&looks->rightFromMid);
     rightToLeftGainAttachment.reset(new SliderAttachment(parameters, "rightToLeftGain", rightToLeftGainSlider));
 
     addAndMakeVisible(leftPreGainSlider);
-    leftPreGainSlider.setLookAndFeel(&leftPanLook);
+    leftPreGainSlider.setLookAndFeel(&looks->leftFromMid);
     leftPreGainAttachment.reset(new SliderAttachment(parameters, "leftPreGain", leftPreGainSlider));
 
     addAndMakeVisible(rightPreGainSlider);
-    rightPreGainSlider.setLookAndFeel(&rightPanLook);
+    rightPreGainSlider.setLookAndFeel(&looks->rightFromMid);
     rightPreGainAttachment.reset(new SliderAttachment(parameters, "rightPreGain", rightPreGainSlider));
 
     addAndMakeVisible(leftToRightGainSlider);
-    leftToRightGainSlider.setLookAndFeel(&leftPanLook);
+    leftToRightGainSlider.setLookAndFeel(&looks->leftFromMid);
     leftToRightGainAttachment.reset(new SliderAttachment(parameters, "leftToRightGain", leftToRightGainSlider));
 }
 
@@ -33,6 +31,28 @@ MixerComponent::~MixerComponent() {}
 void MixerComponent::paint(juce::Graphics& g) {
     g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
 
+    // the scale only depends on the size, so the rendered layer is shared
+    // through the process-wide ImageCache by every editor at the same size
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const auto key = (String("PantheonMixerScale_") + String(getWidth()) + "x" + String(getHeight())
+                      + "@" + String(scale)).hashCode64();
+
+    auto layer = ImageCache::getFromHashCode(key);
+
+    if (! layer.isValid()) {
+        layer = Image(Image::ARGB, jmax(1, roundToInt((float)getWidth() * scale)), jmax(1, roundToInt((float)getHeight() * scale)), true);
+
+        Graphics lg(layer);
+        lg.addTransform(AffineTransform::scale(scale));
+        paintScale(lg);
+
+        ImageCache::addImageToCache(layer, key);
+    }
+
+    g.drawImageTransformed(layer, AffineTransform::scale(1.f / scale));
+}
+
+void MixerComponent::paintScale(Graphics& g) {
     const auto bounds = getLocalBounds().toFloat();
     const float width = bounds.getWidth();
 
@@ -20,8 +20,7 @@ private:
     using SliderAttachment = AudioProcessorValueTreeState::SliderAttachment;
     using SliderAttachmentPtr = std::unique_ptr<SliderAttachment>;
 
-    PanLook leftPanLook;
-    PanLook rightPanLook;
+    SharedResourcePointer<PanLooks> looks;
 
     Slider rightToLeftGainSlider;
     Slider leftPreGainSlider;
@@ -33,5 +32,7 @@ private:
     SliderAttachmentPtr rightPreGainAttachment = nullptr;
     SliderAttachmentPtr leftToRightGainAttachment = nullptr;
 
+    void paintScale(Graphics&);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MixerComponent)
 };
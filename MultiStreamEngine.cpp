@@ -0,0 +1,182 @@
+#include "MultiStreamEngine.h"
+#include <algorithm>
+
+//==============================================================================
+struct MultiStreamEngine::Stream {
+    Stream(const String& streamName, double rate, int64 length, int blockSize)
+        : sampleRate(rate)
+        , lengthInSamples(length)
+        , engine(new AudioPluginAudioProcessor())
+        , buffer(2, blockSize)
+    {
+        stats.name = streamName;
+        stats.sampleRate = rate;
+
+        engine->setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        engine->prepareToPlay(sampleRate, blockSize);
+    }
+
+    ~Stream() {
+        engine->releaseResources();
+    }
+
+    bool isFinished() const noexcept { return position >= lengthInSamples; }
+
+    // stream time at which the next block is due, were this running in realtime
+    double getNextDeadline(int blockSize) const noexcept {
+        return (double)(position + blockSize) / sampleRate;
+    }
+
+    void renderBlock(int blockSize, double runStartMs, double cycleStartMs) {
+        const auto numSamples = (int)jmin((int64)blockSize, lengthInSamples - position);
+        buffer.setSize(2, numSamples, false, false, true);
+
+        if (reader != nullptr) {
+            reader->read(&buffer, 0, numSamples, position, true, true);
+        } else {
+            // loopback stand-in: a quiet decorrelated noise pair
+            for (int ch = 0; ch < 2; ++ch) {
+                auto* samples = buffer.getWritePointer(ch);
+
+                for (int i = 0; i < numSamples; ++i) {
+                    samples[i] = 0.25f * (2.f * random.nextFloat() - 1.f);
+                }
+            }
+        }
+
+        const auto processStart = Time::getMillisecondCounterHiRes();
+        engine->processBlock(buffer, midi);
+        const auto processEnd = Time::getMillisecondCounterHiRes();
+
+        if (writer != nullptr) {
+            writer->writeFromAudioSampleBuffer(buffer, 0, numSamples);
+        }
+
+        position += numSamples;
+
+        const auto latency = processEnd - cycleStartMs;
+        stats.samplesProcessed += numSamples;
+        stats.blocksProcessed += 1;
+        stats.totalLatencyMs += latency;
+        stats.worstLatencyMs = jmax(stats.worstLatencyMs, latency);
+        stats.totalProcessMs += processEnd - processStart;
+
+        if (processEnd - runStartMs > 1000. * (double)position / sampleRate) {
+            stats.deadlineMisses += 1;
+        }
+    }
+
+    //==============================================================================
+    const double sampleRate;
+    const int64 lengthInSamples;
+    int64 position { 0 };
+
+    std::unique_ptr<AudioFormatReader> reader;
+    std::unique_ptr<AudioFormatWriter> writer;
+    std::unique_ptr<AudioPluginAudioProcessor> engine;
+
+    AudioBuffer<float> buffer;
+    MidiBuffer midi;
+    Random random;
+
+    StreamStats stats;
+};
+
+//==============================================================================
+MultiStreamEngine::MultiStreamEngine(int numThreads, int newBlockSize)
+    : pool(numThreads)
+    , blockSize(jmax(16, newBlockSize))
+{
+    formatManager.registerBasicFormats();
+}
+
+MultiStreamEngine::~MultiStreamEngine() {
+}
+
+void MultiStreamEngine::addFileStream(const File& input, const File& output) {
+    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(input));
+
+    if (reader == nullptr) {
+        ConsoleApplication::fail("Can't read " + input.getFullPathName());
+    }
+
+    auto stream = std::make_unique<Stream>(input.getFileName(), reader->sampleRate, reader->lengthInSamples, blockSize);
+
+    if (output != File()) {
+        output.deleteFile();
+
+        WavAudioFormat wav;
+        std::unique_ptr<FileOutputStream> outputStream(output.createOutputStream());
+
+        if (outputStream != nullptr) {
+            stream->writer.reset(wav.createWriterFor(outputStream.get(), reader->sampleRate, 2, 24, {}, 0));
+        }
+
+        if (stream->writer == nullptr) {
+            ConsoleApplication::fail("Can't write " + output.getFullPathName());
+        }
+
+        outputStream.release();
+    }
+
+    stream->reader = std::move(reader);
+
+    // a file render has to come out the same on any machine, so never below full
+    // quality; the loopbacks stand in for live input and keep the governor
+    stream->engine->setNonRealtime(true);
+
+    streams.push_back(std::move(stream));
+}
+
+void MultiStreamEngine::addLoopbackStream(double sampleRate, double lengthInSeconds) {
+    const auto name = "loopback " + String((int)streams.size() + 1);
+    streams.push_back(std::make_unique<Stream>(name, sampleRate, (int64)(sampleRate * lengthInSeconds), blockSize));
+}
+
+double MultiStreamEngine::run() {
+    std::vector<Stream*> active;
+    std::vector<WorkStealingPool::Job> jobs;
+
+    const auto runStart = Time::getMillisecondCounterHiRes();
+
+    for (;;) {
+        active.clear();
+
+        for (auto& stream : streams) {
+            if (! stream->isFinished()) {
+                active.push_back(stream.get());
+            }
+        }
+
+        if (active.empty()) {
+            break;
+        }
+
+        std::sort(active.begin(), active.end(), [this](const Stream* a, const Stream* b) {
+            return a->getNextDeadline(blockSize) < b->getNextDeadline(blockSize);
+        });
+
+        const auto cycleStart = Time::getMillisecondCounterHiRes();
+        const auto size = blockSize;
+
+        jobs.clear();
+
+        for (auto* stream : active) {
+            jobs.emplace_back([stream, size, runStart, cycleStart] { stream->renderBlock(size, runStart, cycleStart); });
+        }
+
+        pool.runBatch(jobs);
+    }
+
+    return (Time::getMillisecondCounterHiRes() - runStart) / 1000.;
+}
+
+std::vector<MultiStreamEngine::StreamStats> MultiStreamEngine::getStats() const {
+    std::vector<StreamStats> stats;
+
+    for (const auto& stream : streams) {
+        stats.push_back(stream->stats);
+    }
+
+    return stats;
+}
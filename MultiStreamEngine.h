@@ -0,0 +1,56 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+#include <vector>
+
+#include "PluginProcessor.h"
+#include "WorkStealingPool.h"
+
+//==============================================================================
+// Hosts many independent Pantheon engines, one per input stream, each with its
+// own parameter state. Every block cycle renders one block per stream on a
+// WorkStealingPool, dealt out earliest deadline first.
+class MultiStreamEngine {
+public:
+    struct StreamStats {
+        String name;
+        double sampleRate { 0. };
+        int64 samplesProcessed { 0 };
+        int blocksProcessed { 0 };
+        double totalLatencyMs { 0. };   // cycle start to block done
+        double worstLatencyMs { 0. };
+        double totalProcessMs { 0. };   // time spent inside processBlock
+        int deadlineMisses { 0 };
+    };
+
+    MultiStreamEngine(int numThreads, int blockSize);
+    ~MultiStreamEngine();
+
+    // a stream reading a file, optionally written back out as a wav
+    void addFileStream(const File& input, const File& output = {});
+
+    // a generated stand-in for a live loopback source
+    void addLoopbackStream(double sampleRate, double lengthInSeconds);
+
+    int getNumStreams() const noexcept { return (int)streams.size(); }
+    int getNumThreads() const noexcept { return pool.getNumThreads(); }
+
+    // renders every stream to its end; returns the wall time in seconds
+    double run();
+
+    std::vector<StreamStats> getStats() const;
+
+private:
+    //==============================================================================
+    struct Stream;
+
+    AudioFormatManager formatManager;
+    WorkStealingPool pool;
+    const int blockSize;
+
+    std::vector<std::unique_ptr<Stream>> streams;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MultiStreamEngine)
+};
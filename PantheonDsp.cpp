@@ -0,0 +1,185 @@
+#include "PantheonDsp.h"
+
+#include <JuceHeader.h>
+#include <new>
+
+#include "Engine.h"
+#include "Parameters.h"
+
+//==============================================================================
+struct pantheon_dsp {
+    explicit pantheon_dsp(const AudioChannelSet& channelLayout)
+        : layout(channelLayout)
+    {
+    }
+
+    AudioChannelSet layout;
+    process::Parameters parameters;
+    process::Engine engine { parameters };
+
+    // planar copy of the interleaved frames
+    AudioBuffer<float> planar;
+    int maxBlockSize { 0 };
+};
+
+namespace {
+    AudioChannelSet getLayout(int numChannels) {
+        switch (numChannels) {
+            case 2: return AudioChannelSet::stereo();
+            case 6: return AudioChannelSet::create5point1();
+            case 8: return AudioChannelSet::create7point1();
+            case 12: return AudioChannelSet::create7point1point4();
+            default: return AudioChannelSet::disabled();
+        }
+    }
+
+    bool isValidIndex(int index) noexcept {
+        return isPositiveAndBelow(index, process::Parameters::numParameters);
+    }
+}
+
+//==============================================================================
+pantheon_dsp* pantheon_dsp_create(int num_channels) {
+    const auto layout = getLayout(num_channels);
+
+    if (layout.isDisabled()) {
+        return nullptr;
+    }
+
+    return new (std::nothrow) pantheon_dsp(layout);
+}
+
+void pantheon_dsp_destroy(pantheon_dsp* dsp) {
+    delete dsp;
+}
+
+pantheon_dsp_result pantheon_dsp_prepare(pantheon_dsp* dsp, double sample_rate, int max_block_size) {
+    if (dsp == nullptr || sample_rate <= 0. || max_block_size <= 0) {
+        return PANTHEON_DSP_INVALID_ARGUMENT;
+    }
+
+    // nothing may throw across the C boundary
+    try {
+        dsp->planar.setSize(dsp->layout.size(), max_block_size);
+        dsp->engine.prepare(dsp->layout, sample_rate, max_block_size);
+        dsp->maxBlockSize = max_block_size;
+    } catch (const std::bad_alloc&) {
+        dsp->engine.release();
+        dsp->maxBlockSize = 0;
+        return PANTHEON_DSP_OUT_OF_MEMORY;
+    }
+
+    return PANTHEON_DSP_OK;
+}
+
+void pantheon_dsp_set_lock_memory(pantheon_dsp* dsp, int enabled) {
+    if (dsp != nullptr) {
+        dsp->engine.setLockMemory(enabled != 0);
+    }
+}
+
+int pantheon_dsp_get_memory_locked(const pantheon_dsp* dsp) {
+    return dsp != nullptr && dsp->engine.isMemoryLocked() ? 1 : 0;
+}
+
+void pantheon_dsp_reset(pantheon_dsp* dsp) {
+    if (dsp != nullptr) {
+        dsp->engine.reset();
+    }
+}
+
+int pantheon_dsp_get_latency(const pantheon_dsp* dsp) {
+    return dsp != nullptr ? dsp->engine.getLatencyInSamples() : 0;
+}
+
+void pantheon_dsp_set_adaptive_quality(pantheon_dsp* dsp, int enabled) {
+    if (dsp != nullptr) {
+        dsp->engine.setAdaptiveQuality(enabled != 0);
+    }
+}
+
+int pantheon_dsp_get_quality_level(const pantheon_dsp* dsp) {
+    return dsp != nullptr ? (int)dsp->engine.getQuality() : 0;
+}
+
+int pantheon_dsp_get_quality_transitions(const pantheon_dsp* dsp) {
+    return dsp != nullptr ? dsp->engine.getNumQualityTransitions() : 0;
+}
+
+//==============================================================================
+int pantheon_dsp_get_num_params(void) {
+    return process::Parameters::numParameters;
+}
+
+const char* pantheon_dsp_get_param_id(int index) {
+    return isValidIndex(index) ? process::Parameters::getInfo((process::ParameterId)index).id : nullptr;
+}
+
+int pantheon_dsp_find_param(const char* id) {
+    process::ParameterId result;
+    return process::Parameters::findId(id, result) ? (int)result : -1;
+}
+
+pantheon_dsp_result pantheon_dsp_set_param(pantheon_dsp* dsp, int index, float value) {
+    if (dsp == nullptr) {
+        return PANTHEON_DSP_INVALID_ARGUMENT;
+    }
+
+    if (! isValidIndex(index)) {
+        return PANTHEON_DSP_UNKNOWN_PARAMETER;
+    }
+
+    dsp->parameters.set((process::ParameterId)index, value);
+    return PANTHEON_DSP_OK;
+}
+
+pantheon_dsp_result pantheon_dsp_set_param_by_id(pantheon_dsp* dsp, const char* id, float value) {
+    return pantheon_dsp_set_param(dsp, pantheon_dsp_find_param(id), value);
+}
+
+float pantheon_dsp_get_param(const pantheon_dsp* dsp, int index) {
+    return dsp != nullptr && isValidIndex(index) ? dsp->parameters.get((process::ParameterId)index) : 0.f;
+}
+
+//==============================================================================
+pantheon_dsp_result pantheon_dsp_process_planar(pantheon_dsp* dsp, float* const* channels, int num_frames) {
+    if (dsp == nullptr || channels == nullptr || num_frames < 0 || num_frames > dsp->maxBlockSize) {
+        return dsp != nullptr && dsp->maxBlockSize == 0 ? PANTHEON_DSP_NOT_PREPARED : PANTHEON_DSP_INVALID_ARGUMENT;
+    }
+
+    ScopedNoDenormals noDenormals;
+
+    // refers to the caller's channels, no copy
+    AudioBuffer<float> buffer(channels, dsp->layout.size(), num_frames);
+    dsp->engine.process(buffer);
+
+    return PANTHEON_DSP_OK;
+}
+
+pantheon_dsp_result pantheon_dsp_process_interleaved(pantheon_dsp* dsp, float* frames, int num_frames) {
+    if (dsp == nullptr || frames == nullptr || num_frames < 0 || num_frames > dsp->maxBlockSize) {
+        return dsp != nullptr && dsp->maxBlockSize == 0 ? PANTHEON_DSP_NOT_PREPARED : PANTHEON_DSP_INVALID_ARGUMENT;
+    }
+
+    ScopedNoDenormals noDenormals;
+
+    const auto numChannels = dsp->layout.size();
+    auto* const* channels = dsp->planar.getArrayOfWritePointers();
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+        for (int i = 0; i < num_frames; ++i) {
+            channels[ch][i] = frames[i * numChannels + ch];
+        }
+    }
+
+    AudioBuffer<float> buffer(channels, numChannels, num_frames);
+    dsp->engine.process(buffer);
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+        for (int i = 0; i < num_frames; ++i) {
+            frames[i * numChannels + ch] = channels[ch][i];
+        }
+    }
+
+    return PANTHEON_DSP_OK;
+}
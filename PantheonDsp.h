@@ -0,0 +1,64 @@
+#pragma once
+
+/*
+    Pantheon's shaping chain with no plugin wrapper, message thread or GUI:
+    create, prepare, set parameters and process from any C or C++ host.
+
+    Parameters take the same IDs and plain values as the plugin's. Everything
+    but create, prepare and destroy is realtime safe; set_param can be called
+    from any thread while another one processes.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct pantheon_dsp pantheon_dsp;
+
+typedef enum pantheon_dsp_result {
+    PANTHEON_DSP_OK = 0,
+    PANTHEON_DSP_INVALID_ARGUMENT,
+    PANTHEON_DSP_NOT_PREPARED,
+    PANTHEON_DSP_UNKNOWN_PARAMETER,
+    PANTHEON_DSP_OUT_OF_MEMORY
+} pantheon_dsp_result;
+
+/* 2 (stereo), 6 (5.1), 8 (7.1) or 12 (7.1.4) channels, in the plugin's channel
+   order; NULL for any other count */
+pantheon_dsp* pantheon_dsp_create(int num_channels);
+void pantheon_dsp_destroy(pantheon_dsp* dsp);
+
+/* allocates; calls to process must not pass more than max_block_size frames */
+pantheon_dsp_result pantheon_dsp_prepare(pantheon_dsp* dsp, double sample_rate, int max_block_size);
+
+/* off by default; from the next prepare on, locks the engine's memory into
+   RAM where the OS allows it, and get_memory_locked says whether it did */
+void pantheon_dsp_set_lock_memory(pantheon_dsp* dsp, int enabled);
+int pantheon_dsp_get_memory_locked(const pantheon_dsp* dsp);
+void pantheon_dsp_reset(pantheon_dsp* dsp);
+
+/* frames of latency, non-zero in spectral mode */
+int pantheon_dsp_get_latency(const pantheon_dsp* dsp);
+
+/* off by default; when on, sustained load drops processing to cheaper levels:
+   0 full, 1 reduced, 2 economy */
+void pantheon_dsp_set_adaptive_quality(pantheon_dsp* dsp, int enabled);
+int pantheon_dsp_get_quality_level(const pantheon_dsp* dsp);
+int pantheon_dsp_get_quality_transitions(const pantheon_dsp* dsp);
+
+/* parameters by index, 0 to get_num_params - 1, or by plugin ID */
+int pantheon_dsp_get_num_params(void);
+const char* pantheon_dsp_get_param_id(int index);
+int pantheon_dsp_find_param(const char* id);
+
+pantheon_dsp_result pantheon_dsp_set_param(pantheon_dsp* dsp, int index, float value);
+pantheon_dsp_result pantheon_dsp_set_param_by_id(pantheon_dsp* dsp, const char* id, float value);
+float pantheon_dsp_get_param(const pantheon_dsp* dsp, int index);
+
+/* in place; one pointer per channel, or frames of num_channels samples */
+pantheon_dsp_result pantheon_dsp_process_planar(pantheon_dsp* dsp, float* const* channels, int num_frames);
+pantheon_dsp_result pantheon_dsp_process_interleaved(pantheon_dsp* dsp, float* frames, int num_frames);
+
+#ifdef __cplusplus
+}
+#endif
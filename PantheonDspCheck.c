@@ -0,0 +1,93 @@
+#include <math.h>
+#include <stdio.h>
+
+#include "PantheonDsp.h"
+
+/*
+    Links a plain C program against pantheon_dsp and runs every entry point
+    once, so the library is known to stand on its own: no C++ or JUCE on the
+    caller's side, and nothing left unresolved. Exits non-zero on the first
+    call that doesn't do what PantheonDsp.h says.
+*/
+
+#define NUM_FRAMES 256
+
+static int failures = 0;
+
+static void check(int condition, const char* what) {
+    if (! condition) {
+        printf("FAIL %s\n", what);
+        ++failures;
+    }
+}
+
+static int isFinite(const float* samples, int count) {
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        if (! isfinite(samples[i])) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+int main(void) {
+    static float left[NUM_FRAMES], right[NUM_FRAMES], interleaved[2 * NUM_FRAMES];
+    float* channels[2] = { left, right };
+    pantheon_dsp* dsp;
+    int i, index;
+
+    check(pantheon_dsp_create(3) == NULL, "create rejects 3 channels");
+
+    dsp = pantheon_dsp_create(2);
+    check(dsp != NULL, "create stereo");
+
+    if (dsp == NULL) {
+        return 1;
+    }
+
+    check(pantheon_dsp_process_planar(dsp, channels, NUM_FRAMES) == PANTHEON_DSP_NOT_PREPARED, "process before prepare");
+    check(pantheon_dsp_prepare(dsp, 48000., NUM_FRAMES) == PANTHEON_DSP_OK, "prepare");
+
+    check(pantheon_dsp_get_num_params() > 0, "has parameters");
+    index = pantheon_dsp_find_param("delayLine");
+    check(index >= 0, "find delayLine");
+    check(pantheon_dsp_find_param("noSuchParameter") < 0, "unknown ID");
+    check(pantheon_dsp_set_param(dsp, index, 0.25f) == PANTHEON_DSP_OK, "set by index");
+    check(pantheon_dsp_get_param(dsp, index) == 0.25f, "get by index");
+    check(pantheon_dsp_set_param_by_id(dsp, "allPassFreq", 0.5f) == PANTHEON_DSP_OK, "set by ID");
+    check(pantheon_dsp_set_param_by_id(dsp, "noSuchParameter", 0.f) == PANTHEON_DSP_UNKNOWN_PARAMETER, "set unknown ID");
+
+    for (i = 0; i < NUM_FRAMES; ++i) {
+        left[i] = 0.5f * sinf(0.05f * (float)i);
+        right[i] = 0.5f * cosf(0.03f * (float)i);
+        interleaved[2 * i] = left[i];
+        interleaved[2 * i + 1] = right[i];
+    }
+
+    check(pantheon_dsp_process_planar(dsp, channels, 0) == PANTHEON_DSP_OK, "empty planar block");
+    check(pantheon_dsp_process_interleaved(dsp, interleaved, 0) == PANTHEON_DSP_OK, "empty interleaved block");
+    check(pantheon_dsp_process_planar(dsp, channels, NUM_FRAMES + 1) == PANTHEON_DSP_INVALID_ARGUMENT, "oversized block");
+
+    for (i = 0; i < 16; ++i) {
+        check(pantheon_dsp_process_planar(dsp, channels, NUM_FRAMES) == PANTHEON_DSP_OK, "planar block");
+        check(pantheon_dsp_process_interleaved(dsp, interleaved, NUM_FRAMES) == PANTHEON_DSP_OK, "interleaved block");
+    }
+
+    check(isFinite(left, NUM_FRAMES) && isFinite(right, NUM_FRAMES), "planar output is finite");
+    check(isFinite(interleaved, 2 * NUM_FRAMES), "interleaved output is finite");
+
+    check(pantheon_dsp_set_param_by_id(dsp, "spectralMode", 1.f) == PANTHEON_DSP_OK, "spectral mode");
+    check(pantheon_dsp_process_planar(dsp, channels, NUM_FRAMES) == PANTHEON_DSP_OK, "spectral block");
+    check(pantheon_dsp_get_latency(dsp) > 0, "spectral latency");
+
+    pantheon_dsp_set_adaptive_quality(dsp, 1);
+    check(pantheon_dsp_get_quality_level(dsp) >= 0, "quality level");
+    pantheon_dsp_reset(dsp);
+    pantheon_dsp_destroy(dsp);
+
+    printf(failures == 0 ? "ok\n" : "%d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
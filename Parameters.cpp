@@ -0,0 +1,101 @@
+#include "Parameters.h"
+#include <array>
+#include <cstring>
+
+#include "FxStages.h"
+
+namespace process {
+    //==============================================================================
+    // same IDs, ranges and defaults as the plugin's parameter layout; the Fx
+    // stages declare their own, see FxStages.h
+    struct CoreParameter {
+        ParameterId index;
+        ParameterInfo info;
+    };
+
+    static const CoreParameter coreParameters[] = {
+        {ParameterId::inputGain, {"inputGain", 0.f, 2.f, 1.f}},
+        {ParameterId::inputPan, {"inputPan", -1.f, 1.f, 0.f}},
+        {ParameterId::panLaw, {"panLaw", 0.f, 3.f, 1.f}},
+        {ParameterId::leftPreGain, {"leftPreGain", -4.f, 4.f, 1.f}},
+        {ParameterId::rightPreGain, {"rightPreGain", -4.f, 4.f, 1.f}},
+        {ParameterId::leftToRightGain, {"leftToRightGain", -4.f, 4.f, 0.f}},
+        {ParameterId::rightToLeftGain, {"rightToLeftGain", -4.f, 4.f, 0.f}},
+        {ParameterId::fxPosition, {"fxPosition", 0.f, 1.f, 1.f}},
+        {ParameterId::spectralMode, {"spectralMode", 0.f, 1.f, 0.f}},
+        {ParameterId::spectralOverlap, {"spectralOverlap", 0.f, 2.f, 1.f}},
+        {ParameterId::spectralWidthLow, {"spectralWidthLow", 0.f, 2.f, 1.f}},
+        {ParameterId::spectralWidthHigh, {"spectralWidthHigh", 0.f, 2.f, 1.f}},
+        {ParameterId::spectralPanLow, {"spectralPanLow", -1.f, 1.f, 0.f}},
+        {ParameterId::spectralPanHigh, {"spectralPanHigh", -1.f, 1.f, 0.f}},
+        {ParameterId::spectralRotation, {"spectralRotation", -180.f, 180.f, 0.f}},
+        {ParameterId::bypass, {"bypass", 0.f, 1.f, 0.f}},
+        {ParameterId::bypassState, {"bypassState", 0.f, 1.f, 1.f}},
+    };
+
+    static const ParameterInfo* getParameterInfos() noexcept {
+        static const auto infos = [] {
+            std::array<ParameterInfo, Parameters::numParameters> result {};
+
+            for (const auto& parameter : coreParameters) {
+                result[(size_t)parameter.index] = parameter.info;
+            }
+
+            FxStages::forEachParameter([&result](const StageParameter& parameter) {
+                result[(size_t)parameter.index] = {parameter.id, parameter.minimum, parameter.maximum, parameter.defaultValue};
+            });
+
+            // every ParameterId declared exactly once, by the core or a stage
+            for (const auto& info : result) {
+                jassert(info.id != nullptr);
+                ignoreUnused(info);
+            }
+
+            return result;
+        }();
+
+        return infos.data();
+    }
+
+    //==============================================================================
+    Parameters::Parameters() noexcept {
+        const auto* parameterInfos = getParameterInfos();
+
+        for (int i = 0; i < numParameters; ++i) {
+            storage[i].store(parameterInfos[i].defaultValue);
+            values[i] = &storage[i];
+        }
+    }
+
+    const ParameterInfo& Parameters::getInfo(ParameterId id) noexcept {
+        jassert(isPositiveAndBelow((int)id, numParameters));
+        return getParameterInfos()[(int)id];
+    }
+
+    bool Parameters::findId(const char* id, ParameterId& result) noexcept {
+        if (id == nullptr) {
+            return false;
+        }
+
+        const auto* parameterInfos = getParameterInfos();
+
+        for (int i = 0; i < numParameters; ++i) {
+            if (std::strcmp(parameterInfos[i].id, id) == 0) {
+                result = (ParameterId)i;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void Parameters::bind(ParameterId id, std::atomic<float>* value) noexcept {
+        jassert(value != nullptr);
+        values[(int)id] = value;
+    }
+
+    void Parameters::set(ParameterId id, float value) noexcept {
+        const auto& info = getInfo(id);
+        values[(int)id]->store(jlimit(info.minimum, info.maximum, value));
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+namespace process {
+    //==============================================================================
+    // Every parameter the stages read, looked up by index rather than by string.
+    enum class ParameterId {
+        inputGain = 0,
+        inputPan,
+        panLaw,
+        leftPreGain,
+        rightPreGain,
+        leftToRightGain,
+        rightToLeftGain,
+        fxPosition,
+        delayLine,
+        allPassFreq,
+        allPassStages,
+        allPassSpread,
+        spectralMode,
+        spectralOverlap,
+        spectralWidthLow,
+        spectralWidthHigh,
+        spectralPanLow,
+        spectralPanHigh,
+        spectralRotation,
+        bypass,
+        bypassState,
+        delayEnabled,
+        allPassEnabled,
+        delayInterpolation,
+        numParameters
+    };
+
+    struct ParameterInfo {
+        const char* id;
+        float minimum;
+        float maximum;
+        float defaultValue;
+    };
+
+    //==============================================================================
+    // Plain parameter values for the stages. Each value starts out in storage of
+    // its own, at its default; the plugin binds them to its
+    // AudioProcessorValueTreeState instead, so the stages never depend on it.
+    class Parameters {
+    public:
+        static constexpr int numParameters = (int)ParameterId::numParameters;
+
+        Parameters() noexcept;
+
+        static const ParameterInfo& getInfo(ParameterId) noexcept;
+
+        // false if there's no parameter with this ID
+        static bool findId(const char* id, ParameterId& result) noexcept;
+
+        void bind(ParameterId, std::atomic<float>* value) noexcept;
+
+        float get(ParameterId id) const noexcept { return values[(int)id]->load(std::memory_order_relaxed); }
+
+        // clamped to the parameter's range
+        void set(ParameterId, float value) noexcept;
+
+    private:
+        //==============================================================================
+        std::atomic<float> storage[numParameters];
+        std::atomic<float>* values[numParameters] {};
+
+        //==============================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Parameters)
+    };
+}
@@ -8,12 +8,9 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
     , mixerComponent(p, apvts)
     , preComponent(p, apvts)
     , fxComponent(p, apvts)
+    , responseDisplay(p, apvts)
 {
-    panLook.setColour(GroupComponent::outlineColourId, Colours::linen);
-    panLook.setColour(GroupComponent::textColourId, Colours::linen);
-
-    panLook.textH = 20.f;
-    border.setLookAndFeel(&panLook);
+    border.setLookAndFeel(&looks->title);
     border.setText("Pantheon");
 
     addAndMakeVisible(preComponent);
@@ -21,6 +18,7 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
     // addAndMakeVisible(postComponent);
     addAndMakeVisible(filler);
     addAndMakeVisible(fxComponent);
+    addAndMakeVisible(responseDisplay);
 
     addAndMakeVisible(border);
 
@@ -96,6 +94,7 @@ void AudioPluginAudioProcessorEditor::resized()
         Track(Fr(5)),
         Track(Fr(10)),
         Track(Fr(1)),
+        Track(Fr(4)),
         // Track(Fr(3)),
     };
     grid.templateColumns = {
@@ -108,6 +107,7 @@ void AudioPluginAudioProcessorEditor::resized()
         GridItem(fxComponent),
         GridItem(mixerComponent).withArea(2, GridItem::Span(2)),
         GridItem(filler).withArea(3, GridItem::Span(2)),
+        GridItem(responseDisplay).withArea(4, GridItem::Span(2)),
     };
 
     border.setBounds(getLocalBounds().reduced(4));
@@ -5,6 +5,7 @@
 #include "FxComponent.h"
 #include "MixerComponent.h"
 #include "PreComponent.h"
+#include "ResponseDisplay.h"
 // #include "BinaryData.h"
 
 //==============================================================================
@@ -32,15 +33,16 @@ private:
     // AudioPluginAudioProcessor& processorRef;
     // AudioProcessorValueTreeState& parameters;
     
+    //==============================================================================
+    SharedResourcePointer<PanLooks> looks;
+
     //==============================================================================
     MixerComponent mixerComponent;
     PreComponent preComponent;
     FillerComp filler;
     FxComponent fxComponent;
+    ResponseDisplay responseDisplay;
 
-    //==============================================================================
-    PanLook panLook;
-    
     //==============================================================================
     GroupComponent border;
 
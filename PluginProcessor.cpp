@@ -15,12 +15,22 @@ AudioPluginAudioProcessor::AudioPluginAudioProcessor()
                      #endif
                        )
     , apvts(*this, nullptr, "PARAMETERS", createParameterLayout())
-    , mainProcessorGraph(new AudioProcessorGraph())
 {
+    for (int i = 0; i < process::Parameters::numParameters; ++i) {
+        const auto id = (process::ParameterId)i;
+        const auto& info = process::Parameters::getInfo(id);
+
+        // the stages' table has to agree with the layout below
+        jassert(apvts.getParameterRange(info.id).start == info.minimum);
+        jassert(apvts.getParameterRange(info.id).end == info.maximum);
+
+        parameters.bind(id, apvts.getRawParameterValue(info.id));
+    }
 }
 
 AudioPluginAudioProcessor::~AudioPluginAudioProcessor()
 {
+    cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -93,48 +103,42 @@ void AudioPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPer
 {
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
-    // prepare APG
-    mainProcessorGraph->setPlayConfigDetails(getMainBusNumInputChannels(),
-                                        getMainBusNumOutputChannels(),
-                                        sampleRate, samplesPerBlock);
-    mainProcessorGraph->prepareToPlay(sampleRate, samplesPerBlock);
-    mainProcessorGraph->clear();
-
-    //==============================================================================
-    audioInputNode = mainProcessorGraph->addNode(std::make_unique<IOProcessor>(IOProcessor::audioInputNode));
-    preProcessorNode = mainProcessorGraph->addNode(std::make_unique<process::PreProcessor>(apvts));
-    fxProcessorNode = mainProcessorGraph->addNode(std::make_unique<process::FxProcessor>(apvts));
-    mixerProcessorNode = mainProcessorGraph->addNode(std::make_unique<process::MixerProcessor>(apvts));
-    audioOutputNode = mainProcessorGraph->addNode(std::make_unique<IOProcessor>(IOProcessor::audioOutputNode));
-
-    for (int ch = 0; ch < 2; ++ch) {
-        mainProcessorGraph->addConnection({
-            {audioInputNode->nodeID, ch},
-            {preProcessorNode->nodeID, ch},
-        });
-
-        mainProcessorGraph->addConnection({
-            {preProcessorNode->nodeID, ch},
-            {fxProcessorNode->nodeID, ch},
-        });
-        
-        mainProcessorGraph->addConnection({
-            {fxProcessorNode->nodeID, ch},
-            {mixerProcessorNode->nodeID, ch},
-        });
-        
-        mainProcessorGraph->addConnection({
-            {mixerProcessorNode->nodeID, ch},
-            {audioOutputNode->nodeID, ch},
-        });
-    }
+
+    // a state set just before has to be in place for the first block
+    stateRestorer.finish();
+
+    const auto layout = getChannelLayoutOfBus(true, 0);
+
+    // the aligner listens to the front pair, over the whole delayLine range
+    const auto pairs = process::getChannelPairs(layout);
+    alignLeftChannel = pairs.empty() ? 0 : pairs.front().first;
+    alignRightChannel = pairs.empty() ? 1 : pairs.front().second;
+    maxDelayInSamples = std::ceil(sampleRate * process::FxProcessor::maxDelayInMilliseconds * 0.001);
+
+    const auto wasAligning = aligner.isRunning();
+    aligner.stop();
+    aligner.prepare(sampleRate, (int)maxDelayInSamples);
+
+    if (wasAligning)
+        aligner.start();
+
+    engine.prepare(layout, sampleRate, samplesPerBlock);
+
+    cancelPendingUpdate();
+    latencyInSamples = engine.getLatencyInSamples();
+    setLatencySamples(latencyInSamples);
 }
 
 void AudioPluginAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
-    mainProcessorGraph->releaseResources();
+    engine.release();
+}
+
+void AudioPluginAudioProcessor::reset()
+{
+    engine.reset();
 }
 
 bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
@@ -143,12 +147,15 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
+    // Stereo, plus the surround layouts the mixer matrix is built for.
     // Some plugin hosts, such as certain GarageBand versions, will only
     // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    const auto& output = layouts.getMainOutputChannelSet();
+
+    if (output != juce::AudioChannelSet::stereo()
+     && output != juce::AudioChannelSet::create5point1()
+     && output != juce::AudioChannelSet::create7point1()
+     && output != juce::AudioChannelSet::create7point1point4())
         return false;
 
     // This checks if the input layout matches the output layout
@@ -163,6 +170,24 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
 
 void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
                                               juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused (midiMessages);
+    processChain (buffer, false);
+}
+
+void AudioPluginAudioProcessor::processBlockBypassed (juce::AudioBuffer<float>& buffer,
+                                                      juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused (midiMessages);
+    processChain (buffer, true);
+}
+
+juce::AudioProcessorParameter* AudioPluginAudioProcessor::getBypassParameter() const
+{
+    return apvts.getParameter("bypass");
+}
+
+void AudioPluginAudioProcessor::processChain (juce::AudioBuffer<float>& buffer, bool forceBypass)
 {
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
@@ -176,10 +201,64 @@ void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     // this code if your algorithm always overwrites all the output channels.
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
-    
-    updateGraph();
 
-    mainProcessorGraph->processBlock(buffer, midiMessages);
+    if (! engine.isPrepared())
+        return;
+
+    // an offline render can't let a block go by on the old state
+    if (isNonRealtime())
+        stateRestorer.decodeNow();
+
+    stateRestorer.pickUp();
+
+    if (aligner.isRunning())
+        aligner.push(buffer.getReadPointer(alignLeftChannel), buffer.getReadPointer(alignRightChannel), buffer.getNumSamples());
+
+    // offline renders have no deadline to keep, so always at full quality
+    engine.setAdaptiveQuality(! isNonRealtime());
+    engine.process(buffer, forceBypass);
+
+    // the spectral mode adds a frame of latency. NOTE: setLatencySamples calls
+    // back into the host, which doesn't belong on the audio thread.
+    const auto latency = engine.getLatencyInSamples();
+
+    if (latencyInSamples.exchange(latency) != latency)
+        triggerAsyncUpdate();
+}
+
+void AudioPluginAudioProcessor::handleAsyncUpdate()
+{
+    setLatencySamples(latencyInSamples);
+}
+
+//==============================================================================
+void AudioPluginAudioProcessor::startAlignment()
+{
+    aligner.start();
+}
+
+void AudioPluginAudioProcessor::stopAlignment()
+{
+    aligner.stop();
+}
+
+float AudioPluginAudioProcessor::getAlignmentDelayValue(const process::DelayAligner::Estimate& estimate) const
+{
+    // NOTE: negative delays the left channel, positive the right.
+    return juce::jlimit(-1.f, 1.f, -estimate.lagInSamples / (float)maxDelayInSamples);
+}
+
+void AudioPluginAudioProcessor::applyAlignment()
+{
+    const auto value = getAlignmentDelayValue(aligner.getEstimate());
+
+    if (auto* parameter = apvts.getParameter("delayLine")) {
+        parameter->beginChangeGesture();
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+        parameter->endChangeGesture();
+    }
+
+    aligner.stop();
 }
 
 //==============================================================================
@@ -196,6 +275,10 @@ juce::AudioProcessorEditor* AudioPluginAudioProcessor::createEditor()
 //==============================================================================
 void AudioPluginAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
+    // saved mid-restore, the state is the one being restored
+    if (stateRestorer.getPendingState(destData))
+        return;
+
     auto state = apvts.copyState();
 
     std::unique_ptr<XmlElement> xml(state.createXml());
@@ -205,13 +288,7 @@ void AudioPluginAudioProcessor::getStateInformation (juce::MemoryBlock& destData
 
 void AudioPluginAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    std::unique_ptr<XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
-
-    if (xmlState.get() != nullptr) {
-        if (xmlState->hasTagName(apvts.state.getType())) {
-            apvts.replaceState(ValueTree::fromXml(*xmlState));
-        }
-    }
+    stateRestorer.submit(data, sizeInBytes);
 }
 
 AudioProcessorValueTreeState::ParameterLayout AudioPluginAudioProcessor::createParameterLayout() {
@@ -237,6 +314,16 @@ AudioProcessorValueTreeState::ParameterLayout AudioPluginAudioProcessor::createP
         )
     );
 
+    // PAN LAW
+    parameterLayout.add(
+        std::make_unique<AudioParameterChoice>(
+            "panLaw",
+            "Pan Law",
+            StringArray{"Linear", "-3 dB", "-4.5 dB", "-6 dB"},
+            1
+        )
+    );
+
     NormalisableRange<float> mixerRange {-4.f, 4.f, 0.01f, 0.5f, true};
 
     // LEFT PRE-GAIN
@@ -289,85 +376,146 @@ AudioProcessorValueTreeState::ParameterLayout AudioPluginAudioProcessor::createP
         )
     );
 
-    // DELAY LINE
+    // FX STAGES
+    // NOTE: declared by the stages themselves, see FxStages.h.
+    process::FxStages::forEachParameter([&parameterLayout](const process::StageParameter& parameter) {
+        switch (parameter.kind) {
+            case process::StageParameter::Float:
+                parameterLayout.add(
+                    std::make_unique<AudioParameterFloat>(
+                        parameter.id,
+                        parameter.name,
+                        NormalisableRange<float>{parameter.minimum, parameter.maximum, parameter.interval},
+                        parameter.defaultValue
+                    )
+                );
+                break;
+
+            case process::StageParameter::Int:
+                parameterLayout.add(
+                    std::make_unique<AudioParameterInt>(
+                        parameter.id,
+                        parameter.name,
+                        (int)parameter.minimum, (int)parameter.maximum, (int)parameter.defaultValue
+                    )
+                );
+                break;
+
+            case process::StageParameter::Bool:
+                parameterLayout.add(
+                    std::make_unique<AudioParameterBool>(
+                        parameter.id,
+                        parameter.name,
+                        parameter.defaultValue > 0.5f
+                    )
+                );
+                break;
+
+            case process::StageParameter::Choice:
+                parameterLayout.add(
+                    std::make_unique<AudioParameterChoice>(
+                        parameter.id,
+                        parameter.name,
+                        StringArray::fromTokens(parameter.choices, "|", {}),
+                        (int)parameter.defaultValue
+                    )
+                );
+                break;
+        }
+    });
+
+    // SPECTRAL MODE
+    // NOTE: replaces the delay and all-pass with the STFT shaper, adds one FFT of latency.
+    parameterLayout.add(
+        std::make_unique<AudioParameterBool>(
+            "spectralMode",
+            "Spectral Mode",
+            false
+        )
+    );
+
+    // SPECTRAL OVERLAP
+    parameterLayout.add(
+        std::make_unique<AudioParameterChoice>(
+            "spectralOverlap",
+            "Spectral Overlap",
+            StringArray{"2x", "4x", "8x"},
+            1
+        )
+    );
+
+    // SPECTRAL WIDTH
+    // NOTE: side gain at the lowest bin and at nyquist, log-interpolated in between.
+    parameterLayout.add(
+        std::make_unique<AudioParameterFloat>(
+            "spectralWidthLow",
+            "Spectral Width Low",
+            NormalisableRange<float>{0.f, 2.f, 0.01f},
+            1.f
+        )
+    );
+
+    parameterLayout.add(
+        std::make_unique<AudioParameterFloat>(
+            "spectralWidthHigh",
+            "Spectral Width High",
+            NormalisableRange<float>{0.f, 2.f, 0.01f},
+            1.f
+        )
+    );
+
+    // SPECTRAL PAN
     parameterLayout.add(
         std::make_unique<AudioParameterFloat>(
-            "delayLine",
-            "Delay",
-            NormalisableRange<float>{-1.f, 1.f},
+            "spectralPanLow",
+            "Spectral Pan Low",
+            NormalisableRange<float>{-1.f, 1.f, 0.01f},
             0.f
         )
     );
-    
-    // ALL-PASS FILTER
+
     parameterLayout.add(
         std::make_unique<AudioParameterFloat>(
-            "allPassFreq",
-            "All-Pass Filter",
-            NormalisableRange<float>{-1.f, 1.f},
+            "spectralPanHigh",
+            "Spectral Pan High",
+            NormalisableRange<float>{-1.f, 1.f, 0.01f},
             0.f
         )
     );
 
-    return parameterLayout;
-}
+    // SPECTRAL ROTATION
+    // NOTE: side phase rotation in degrees at nyquist, from none at the lowest bin.
+    parameterLayout.add(
+        std::make_unique<AudioParameterFloat>(
+            "spectralRotation",
+            "Spectral Rotation",
+            NormalisableRange<float>{-180.f, 180.f, 0.1f},
+            0.f
+        )
+    );
 
-void AudioPluginAudioProcessor::updateGraph() {
-    bool isPre = *apvts.getRawParameterValue("fxPosition") > 0.5f;
-    
-    if (isPre != prevIsPre) {
-        for (auto connection : mainProcessorGraph->getConnections()) {
-            mainProcessorGraph->removeConnection(connection);
-        }
+    // BYPASS
+    // NOTE: crossfaded; the host's bypass button drives this one.
+    parameterLayout.add(
+        std::make_unique<AudioParameterBool>(
+            "bypass",
+            "Bypass",
+            false
+        )
+    );
 
-        if (isPre) {
-            for (int ch = 0; ch < 2; ++ch) {
-                mainProcessorGraph->addConnection({
-                    {audioInputNode->nodeID, ch},
-                    {preProcessorNode->nodeID, ch},
-                });
-
-                mainProcessorGraph->addConnection({
-                    {preProcessorNode->nodeID, ch},
-                    {fxProcessorNode->nodeID, ch},
-                });
-                
-                mainProcessorGraph->addConnection({
-                    {fxProcessorNode->nodeID, ch},
-                    {mixerProcessorNode->nodeID, ch},
-                });
-                
-                mainProcessorGraph->addConnection({
-                    {mixerProcessorNode->nodeID, ch},
-                    {audioOutputNode->nodeID, ch},
-                });
-            }
-        } else {
-            for (int ch = 0; ch < 2; ++ch) {
-                mainProcessorGraph->addConnection({
-                    {audioInputNode->nodeID, ch},
-                    {preProcessorNode->nodeID, ch},
-                });
-
-                mainProcessorGraph->addConnection({
-                    {preProcessorNode->nodeID, ch},
-                    {mixerProcessorNode->nodeID, ch},
-                });
-                
-                mainProcessorGraph->addConnection({
-                    {mixerProcessorNode->nodeID, ch},
-                    {fxProcessorNode->nodeID, ch},
-                });
-                
-                mainProcessorGraph->addConnection({
-                    {fxProcessorNode->nodeID, ch},
-                    {audioOutputNode->nodeID, ch},
-                });
-            }
-        }
-    }
+    // BYPASS STATE
+    // NOTE: what the delay, all-pass and spectral state do while bypassed.
+    parameterLayout.add(
+        std::make_unique<AudioParameterChoice>(
+            "bypassState",
+            "Bypass State",
+            StringArray{"Freeze", "Flush"},
+            1
+        )
+    );
 
-    prevIsPre = isPre;
+    return parameterLayout;
 }
 
 //==============================================================================
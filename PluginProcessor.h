@@ -1,10 +1,18 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <atomic>
 #include <memory>
+#include <vector>
+
+#include "DelayAligner.h"
+#include "Engine.h"
+#include "Parameters.h"
+#include "StateRestorer.h"
 
 //==============================================================================
-class AudioPluginAudioProcessor  : public juce::AudioProcessor
+class AudioPluginAudioProcessor  : public juce::AudioProcessor,
+                                   private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -14,12 +22,19 @@ public:
     //==============================================================================
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
+    void reset() override;
 
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
     using AudioProcessor::processBlock;
 
+    // both fade to and from the dry signal; see process::Engine
+    void processBlockBypassed (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    using AudioProcessor::processBlockBypassed;
+
+    juce::AudioProcessorParameter* getBypassParameter() const override;
+
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -41,30 +56,66 @@ public:
 
     //==============================================================================
     void getStateInformation (juce::MemoryBlock& destData) override;
+
+    // returns straight away; the state reaches the audio thread at the start of
+    // a block and the parameters shortly after, see StateRestorer
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    bool isRestoringState() const noexcept { return stateRestorer.isPending(); }
+
+    // message thread; decodes and applies a restore in flight now, as prepareToPlay does
+    void finishRestoringState() { stateRestorer.finish(); }
+
+    AudioProcessorValueTreeState& getValueTreeState() noexcept { return apvts; }
+
     //==============================================================================
     AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+    //==============================================================================
+    // bytes of audio-thread state per stage, as laid out by the last prepareToPlay
+    std::vector<process::Arena::Section> getMemoryFootprint() const { return engine.getMemoryFootprint(); }
+    size_t getMemoryFootprintInBytes() const noexcept { return engine.getMemoryFootprintInBytes(); }
+
+    // what the load governor settled on, see process::Quality
+    process::Quality getQuality() const noexcept { return engine.getQuality(); }
+    int getNumQualityTransitions() const noexcept { return engine.getNumQualityTransitions(); }
+
+    //==============================================================================
+    // "analyse and align": estimates the L/R lag of the input in the background
+    void startAlignment();
+    void stopAlignment();
+    bool isAligning() const noexcept { return aligner.isRunning(); }
+    process::DelayAligner::Estimate getAlignmentEstimate() const { return aligner.getEstimate(); }
+
+    // the delayLine value that cancels the estimated lag; applying it stops the analysis
+    float getAlignmentDelayValue(const process::DelayAligner::Estimate&) const;
+    void applyAlignment();
+
 private:
     //==============================================================================
-    AudioProcessorValueTreeState apvts;
+    void processChain (juce::AudioBuffer<float>&, bool forceBypass);
+
+    // reports a latency change seen on the audio thread to the host
+    void handleAsyncUpdate() override;
 
     //==============================================================================
-    using IOProcessor = AudioProcessorGraph::AudioGraphIOProcessor;
-    using Node = AudioProcessorGraph::Node;
+    AudioProcessorValueTreeState apvts;
+
+    // the stages read the apvts values through this, by index
+    process::Parameters parameters;
+
+    process::Engine engine { parameters };
 
-    std::unique_ptr<AudioProcessorGraph> mainProcessorGraph;
+    StateRestorer stateRestorer { apvts, parameters };
 
-    Node::Ptr audioInputNode;
-    Node::Ptr preProcessorNode;
-    Node::Ptr fxProcessorNode;
-    Node::Ptr mixerProcessorNode;
-    Node::Ptr audioOutputNode;
+    // the engine's latency as of the last block, for handleAsyncUpdate
+    std::atomic<int> latencyInSamples { 0 };
 
     //==============================================================================
-    bool prevIsPre { false };
-    void updateGraph();
+    process::DelayAligner aligner;
+    int alignLeftChannel { 0 };
+    int alignRightChannel { 1 };
+    double maxDelayInSamples { 1. };
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPluginAudioProcessor)
@@ -3,20 +3,18 @@
 PreComponent::PreComponent(AudioPluginAudioProcessor& p, AudioProcessorValueTreeState& apvts)
     : processorRef(p)
     , parameters(apvts)
-    , panLook(PanLook::Origin::FromMid)
-    , volLook(PanLook::Origin::FromMin)
     , inputGainSlider(Slider::RotaryHorizontalVerticalDrag, Slider::NoTextBox)
     , inputPanSlider(Slider::RotaryHorizontalVerticalDrag, Slider::NoTextBox)
 {
-    inputGainSlider.setLookAndFeel(&volLook);
+    inputGainSlider.setLookAndFeel(&looks->fromMin);
     addAndMakeVisible(inputGainSlider);
     inputGainAttachment.reset(new SliderAttachment(parameters, "inputGain", inputGainSlider));
 
-    inputPanSlider.setLookAndFeel(&panLook);
+    inputPanSlider.setLookAndFeel(&looks->fromMid);
     addAndMakeVisible(inputPanSlider);
     inputPanAttachment.reset(new SliderAttachment(parameters, "inputPan", inputPanSlider));
 
-    border.setLookAndFeel(&panLook);
+    border.setLookAndFeel(&looks->fromMid);
     border.setText("Pre");
     border.setEnabled(false);
     border.setColour(GroupComponent::outlineColourId, Colours::linen);
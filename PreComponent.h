@@ -20,8 +20,7 @@ private:
     using SliderAttachment = AudioProcessorValueTreeState::SliderAttachment;
     using SliderAttachmentPtr = std::unique_ptr<SliderAttachment>;
 
-    PanLook panLook;
-    PanLook volLook;
+    SharedResourcePointer<PanLooks> looks;
 
     Slider inputGainSlider;
     Slider inputPanSlider;
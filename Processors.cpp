@@ -3,165 +3,436 @@
 
 namespace process {
     //==============================================================================
-    PreProcessor::PreProcessor(AudioProcessorValueTreeState& apvts)
-        : parameters(apvts)
-        , preProcessorChain(new dsp::ProcessorChain<dsp::Gain<float>, dsp::Panner<float>>{})
+    PreProcessor::PreProcessor(const Parameters& values, const AudioChannelSet& layout)
+        : parameters(values)
     {
+        jassert(layout.size() <= maxChannels);
+
+        bool isPaired[maxChannels] {};
+
+        for (const auto& pair : getChannelPairs(layout)) {
+            groupChannels[LeftGroup][groupSizes[LeftGroup]++] = pair.first;
+            groupChannels[RightGroup][groupSizes[RightGroup]++] = pair.second;
+            isPaired[pair.first] = isPaired[pair.second] = true;
+        }
+
+        for (int ch = 0; ch < layout.size(); ++ch) {
+            if (! isPaired[ch]) {
+                groupChannels[UnpairedGroup][groupSizes[UnpairedGroup]++] = ch;
+            }
+        }
+
+        for (int group = 0; group < numGainGroups; ++group) {
+            for (int i = 0; i < groupSizes[group]; ++i) {
+                channelGroups[groupChannels[group][i]] = group;
+            }
+        }
     }
 
-    void PreProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
-        preProcessorChain->get<0>().setRampDurationSeconds((double)samplesPerBlock / sampleRate);
-        preProcessorChain->get<1>().setRule(dsp::PannerRule::squareRoot3dB);
+    size_t PreProcessor::getArenaBytes(const AudioChannelSet&, double, int) noexcept {
+        return Arena::sizeFor<PreProcessor>();
+    }
 
-        preProcessorChain->prepare(
-            {sampleRate, (uint32)samplesPerBlock, 2}
-        );
+    void PreProcessor::prepare(Arena&, double sampleRate, int samplesPerBlock) {
+        coefficientTables = tableRegistry->get(sampleRate);
+
+        gainRampLength = jmax(1, samplesPerBlock);
+
+        for (auto& gain : groupGains) {
+            gain.reset(gainRampLength);
+        }
+
+        reset();
     }
 
-    void PreProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer&) {
+    void PreProcessor::process(AudioBuffer<float>& buffer) noexcept {
         updateParameter();
 
-        dsp::AudioBlock<float>block(buffer);
-        dsp::ProcessContextReplacing<float>context(block);
+        const auto numSamples = buffer.getNumSamples();
+        const auto& k = kernels::get();
+
+        for (int group = 0; group < numGainGroups; ++group) {
+            auto& gain = groupGains[group];
+            const auto* channels = groupChannels[group];
 
-        preProcessorChain->process(context);
+            if (gain.isSmoothing()) {
+                // the ramp never outlasts the prepared block size, past it the gain is flat
+                const auto rampSamples = jmin(numSamples, gainRampLength);
+                const auto start = gain.getCurrentValue();
+                const auto step = (gain.skip(rampSamples) - start) / (float)rampSamples;
+
+                for (int i = 0; i < groupSizes[group]; ++i) {
+                    auto* samples = buffer.getWritePointer(channels[i]);
+                    k.multiplyRamp(samples, start, step, rampSamples);
+                    k.multiply(samples + rampSamples, gain.getTargetValue(), numSamples - rampSamples);
+                }
+            } else {
+                for (int i = 0; i < groupSizes[group]; ++i) {
+                    k.multiply(buffer.getWritePointer(channels[i]), gain.getTargetValue(), numSamples);
+                }
+            }
+        }
     }
 
-    void PreProcessor::reset() {
-        preProcessorChain.reset();
+    void PreProcessor::reset() noexcept {
+        for (auto& gain : groupGains) {
+            gain.setCurrentAndTargetValue(gain.getTargetValue());
+        }
+    }
+
+    bool PreProcessor::isSmoothing() const noexcept {
+        for (const auto& gain : groupGains) {
+            if (gain.isSmoothing()) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    float PreProcessor::getGain(int channel) const noexcept {
+        jassert(isPositiveAndBelow(channel, maxChannels));
+        return groupGains[channelGroups[channel]].getTargetValue();
     }
 
     void PreProcessor::updateParameter() {
-        const auto gainValue = parameters.getRawParameterValue("inputGain")->load();
-        preProcessorChain->get<0>().setGainLinear(gainValue);
+        const auto gainValue = parameters.get(ParameterId::inputGain);
+        const auto panValue = parameters.get(ParameterId::inputPan);
+        const auto panLaw = (PanLaw)(int)parameters.get(ParameterId::panLaw);
+
+        float left, right;
+        coefficientTables->getPanGains(panLaw, panValue, left, right);
+
+        groupGains[LeftGroup].setTargetValue(gainValue * left);
+        groupGains[RightGroup].setTargetValue(gainValue * right);
+        groupGains[UnpairedGroup].setTargetValue(gainValue);
+    }
+
+    void PreProcessor::applyResponse(const Parameters& parameters, const CoefficientTables& tables, ResponseGrid& grid) noexcept {
+        const auto gainValue = parameters.get(ParameterId::inputGain);
+        const auto panLaw = (PanLaw)(int)parameters.get(ParameterId::panLaw);
+
+        float left, right;
+        tables.getPanGains(panLaw, parameters.get(ParameterId::inputPan), left, right);
+
+        grid.multiplyGains(gainValue * left, gainValue * right);
+    }
+
+    //==============================================================================
+    MixerProcessor::MixerProcessor(const Parameters& values, Arena& arena, const AudioChannelSet& layout)
+        : parameters(values)
+        , matrixMixer(createMatrixMixer(arena, layout.size()))
+    {
+        jassert(layout.size() <= maxChannels);
 
-        const auto panValue = parameters.getRawParameterValue("inputPan")->load();
-        preProcessorChain->get<1>().setPan(panValue);
+        bool isPaired[maxChannels] {};
+
+        for (const auto& pair : getChannelPairs(layout)) {
+            pairChannels[numPairs][Left] = pair.first;
+            pairChannels[numPairs][Right] = pair.second;
+            ++numPairs;
+
+            isPaired[pair.first] = isPaired[pair.second] = true;
+        }
+
+        for (int ch = 0; ch < layout.size(); ++ch) {
+            if (! isPaired[ch]) {
+                unpairedChannels[numUnpaired++] = ch;
+            }
+        }
+    }
+
+    size_t MixerProcessor::getArenaBytes(const AudioChannelSet& layout, double, int samplesPerBlock) noexcept {
+        return Arena::sizeFor<MixerProcessor>() + getMatrixMixerArenaBytes(layout.size(), samplesPerBlock);
+    }
+
+    void MixerProcessor::prepare(Arena& arena, double, int samplesPerBlock) {
+        matrixMixer->prepare(arena, samplesPerBlock);
+
+        // start from the current settings instead of ramping in from silence
+        updateParameter();
+        matrixMixer->reset();
+    }
+
+    void MixerProcessor::process(AudioBuffer<float>& buffer) noexcept {
+        updateParameter();
+
+        matrixMixer->process(buffer);
+    }
+
+    void MixerProcessor::reset() noexcept {
+        matrixMixer->reset();
+    }
+
+    void MixerProcessor::updateParameter() {
+        const auto leftPreGain = parameters.get(ParameterId::leftPreGain);
+        const auto leftToRightGain = parameters.get(ParameterId::leftToRightGain);
+        const auto rightToLeftGain = parameters.get(ParameterId::rightToLeftGain);
+        const auto rightPreGain = parameters.get(ParameterId::rightPreGain);
+
+        // every left/right pair gets the same bleed, everything else passes through
+        for (int pair = 0; pair < numPairs; ++pair) {
+            const auto left = pairChannels[pair][Left];
+            const auto right = pairChannels[pair][Right];
+
+            matrixMixer->setGain(left, left, leftPreGain);
+            matrixMixer->setGain(left, right, leftToRightGain);
+            matrixMixer->setGain(right, left, rightToLeftGain);
+            matrixMixer->setGain(right, right, rightPreGain);
+        }
+
+        for (int i = 0; i < numUnpaired; ++i) {
+            matrixMixer->setGain(unpairedChannels[i], unpairedChannels[i], 1.f);
+        }
+    }
+
+    void MixerProcessor::applyResponse(const Parameters& parameters, const CoefficientTables&, ResponseGrid& grid) noexcept {
+        grid.mix(parameters.get(ParameterId::leftPreGain),
+                 parameters.get(ParameterId::leftToRightGain),
+                 parameters.get(ParameterId::rightToLeftGain),
+                 parameters.get(ParameterId::rightPreGain));
     }
 
     //==============================================================================
-    MixerProcessor::MixerProcessor(AudioProcessorValueTreeState& apvts)
-        : parameters(apvts)
-        , mixerProcessorGraph(new AudioProcessorGraph{})
+    FxProcessor::FxProcessor(const Parameters& values, const AudioChannelSet& layout)
+        : parameters(values)
     {
+        const auto pairs = getChannelPairs(layout);
+
+        if (! pairs.empty()) {
+            leftChannel = pairs.front().first;
+            rightChannel = pairs.front().second;
+        }
     }
 
-    void MixerProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
-        //==============================================================================
-        mixerProcessorGraph->setPlayConfigDetails(getMainBusNumInputChannels(),
-                                        getMainBusNumOutputChannels(),
-                                        sampleRate, samplesPerBlock);
-        mixerProcessorGraph->prepareToPlay(sampleRate, samplesPerBlock);
-        mixerProcessorGraph->clear();
-
-        //==============================================================================
-        audioInputNode = mixerProcessorGraph->addNode(std::make_unique<IOProcessor>(IOProcessor::audioInputNode));
-        audioOutputNode = mixerProcessorGraph->addNode(std::make_unique<IOProcessor>(IOProcessor::audioOutputNode));
-
-        leftPreGainUnitNode = mixerProcessorGraph->addNode(std::make_unique<MixerUnit<Left, Left>>(parameters));
-        leftToRightGainUnitNode = mixerProcessorGraph->addNode(std::make_unique<MixerUnit<Left, Right>>(parameters));
-        rightToLeftGainUnitNode = mixerProcessorGraph->addNode(std::make_unique<MixerUnit<Right, Left>>(parameters));
-        rightPreGainUnitNode = mixerProcessorGraph->addNode(std::make_unique<MixerUnit<Right, Right>>(parameters));
-
-        //==============================================================================
-        for (int ch = 0; ch < 2; ++ch) {
-            if (ch == Left) {
-                // IN.L -> LL
-                mixerProcessorGraph->addConnection({{audioInputNode->nodeID, ch}, 
-                                            {leftPreGainUnitNode->nodeID, 0}});
-
-                // IN.L -> LR
-                mixerProcessorGraph->addConnection({{audioInputNode->nodeID, ch},
-                                            {leftToRightGainUnitNode->nodeID, 0}});
-                
-                // LL => OUT.L
-                mixerProcessorGraph->addConnection({{leftPreGainUnitNode->nodeID, 0},                
-                                            {audioOutputNode->nodeID, ch}});
-                
-                // RL => OUT.L
-                mixerProcessorGraph->addConnection({{rightToLeftGainUnitNode->nodeID, 0},                
-                                            {audioOutputNode->nodeID, ch}});
-            } else {
-                // IN.R -> RR
-                mixerProcessorGraph->addConnection({{audioInputNode->nodeID, ch},
-                                            {rightPreGainUnitNode->nodeID, 0}});
-
-                // IN.R -> RL
-                mixerProcessorGraph->addConnection({{audioInputNode->nodeID, ch},
-                                            {rightToLeftGainUnitNode->nodeID, 0}});
-                
-                // RR => OUT.R
-                mixerProcessorGraph->addConnection({{rightPreGainUnitNode->nodeID, 0},                
-                                            {audioOutputNode->nodeID, ch}});
-
-                // LR => OUT.R
-                mixerProcessorGraph->addConnection({{leftToRightGainUnitNode->nodeID, 0},                
-                                            {audioOutputNode->nodeID, ch}});
+    size_t FxProcessor::getArenaBytes(const AudioChannelSet&, double sampleRate, int samplesPerBlock) noexcept {
+        return Arena::sizeFor<FxProcessor>() + FxStages::getArenaBytes(sampleRate, samplesPerBlock);
+    }
+
+    void FxProcessor::prepare(Arena& arena, double sampleRate, int samplesPerBlock) {
+        coefficientTables = tableRegistry->get(sampleRate);
+
+        stages.prepare(arena, *coefficientTables, sampleRate, samplesPerBlock);
+    }
+
+    void FxProcessor::process(AudioBuffer<float>& buffer) noexcept {
+        stages.process(parameters, buffer.getWritePointer(leftChannel), buffer.getWritePointer(rightChannel), buffer.getNumSamples());
+    }
+
+    void FxProcessor::reset() noexcept {
+        stages.reset();
+    }
+
+    void FxProcessor::applyResponse(const Parameters& parameters, const CoefficientTables& tables, ResponseGrid& grid) noexcept {
+        FxStages::applyResponse(parameters, tables, grid);
+    }
+
+    //==============================================================================
+    SpectralProcessor::SpectralProcessor(const Parameters& values, const AudioChannelSet& layout)
+        : parameters(values)
+    {
+        const auto pairs = getChannelPairs(layout);
+
+        if (! pairs.empty()) {
+            leftChannel = pairs.front().first;
+            rightChannel = pairs.front().second;
+        }
+
+        for (int ch = 0; ch < layout.size(); ++ch) {
+            if (ch != leftChannel && ch != rightChannel) {
+                otherChannels[numOtherChannels++] = ch;
             }
         }
     }
 
-    void MixerProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& midiMessages) {
-        mixerProcessorGraph->processBlock(buffer, midiMessages);
+    size_t SpectralProcessor::getArenaBytes(const AudioChannelSet& layout, double, int) noexcept {
+        return Arena::sizeFor<SpectralProcessor>()
+             + SpectralShaper::getArenaBytes()
+             + (size_t)jmax(0, layout.size() - 2) * Arena::sizeFor<float>(SpectralShaper::fftSize);
     }
 
-    void MixerProcessor::reset() {
-        mixerProcessorGraph->reset();
+    void SpectralProcessor::prepare(Arena& arena, double sampleRate, int) {
+        coefficientTables = tableRegistry->get(sampleRate);
+
+        shaper.prepare(arena, *coefficientTables);
+        updateParameter();
+
+        for (int i = 0; i < numOtherChannels; ++i) {
+            otherDelays[i] = arena.take<float>(SpectralShaper::fftSize);
+        }
+
+        reset();
+    }
+
+    void SpectralProcessor::process(AudioBuffer<float>& buffer) noexcept {
+        updateParameter();
+
+        const auto numSamples = buffer.getNumSamples();
+
+        shaper.process(buffer.getWritePointer(leftChannel), buffer.getWritePointer(rightChannel), numSamples);
+
+        // a ring of exactly the latency: read the old sample, write the new one in its place
+        for (int i = 0; i < numOtherChannels; ++i) {
+            auto* samples = buffer.getWritePointer(otherChannels[i]);
+            auto* ring = otherDelays[i];
+            auto position = delayPosition;
+
+            for (int n = 0; n < numSamples; ++n) {
+                std::swap(samples[n], ring[position]);
+                position = (position + 1) & (SpectralShaper::fftSize - 1);
+            }
+        }
+
+        delayPosition = (delayPosition + numSamples) & (SpectralShaper::fftSize - 1);
+    }
+
+    void SpectralProcessor::reset() noexcept {
+        shaper.reset();
+
+        for (int i = 0; i < numOtherChannels; ++i) {
+            FloatVectorOperations::clear(otherDelays[i], SpectralShaper::fftSize);
+        }
+
+        delayPosition = 0;
+    }
+
+    void SpectralProcessor::updateParameter() {
+        static constexpr int overlaps[] = {2, 4, 8};
+
+        const auto overlapIndex = jlimit(0, 2, (int)parameters.get(ParameterId::spectralOverlap));
+        const auto panLaw = (PanLaw)(int)parameters.get(ParameterId::panLaw);
+        const auto rotation = degreesToRadians(parameters.get(ParameterId::spectralRotation));
+
+        shaper.setOverlap(jmin(overlaps[overlapIndex], maxOverlap));
+        shaper.setCurves({parameters.get(ParameterId::spectralWidthLow),
+                          parameters.get(ParameterId::spectralWidthHigh)},
+                         {parameters.get(ParameterId::spectralPanLow),
+                          parameters.get(ParameterId::spectralPanHigh)},
+                         panLaw,
+                         {0.f, rotation});
+    }
+
+    void SpectralProcessor::setQuality(Quality quality) noexcept {
+        // fewer frames per FFT size, taken up at the next frame boundary without a level change
+        maxOverlap = quality == Quality::Full ? 8 : (quality == Quality::Reduced ? 4 : 2);
+    }
+
+    void SpectralProcessor::applyResponse(const Parameters& parameters, const CoefficientTables& tables, ResponseGrid& grid) noexcept {
+        const auto panLaw = (PanLaw)(int)parameters.get(ParameterId::panLaw);
+        const auto rotation = degreesToRadians(parameters.get(ParameterId::spectralRotation));
+
+        SpectralShaper::applyResponse(grid,
+                                      tables,
+                                      {parameters.get(ParameterId::spectralWidthLow),
+                                       parameters.get(ParameterId::spectralWidthHigh)},
+                                      {parameters.get(ParameterId::spectralPanLow),
+                                       parameters.get(ParameterId::spectralPanHigh)},
+                                      panLaw,
+                                      {0.f, rotation});
     }
 
     //==============================================================================
-    FxProcessor::FxProcessor(AudioProcessorValueTreeState& apvts)
-        : parameters(apvts)
-        , fxProcessorGraph(new AudioProcessorGraph{})
+    StageFolder::StageFolder(Arena& arena, const AudioChannelSet& layout)
+        : numChannels(layout.size())
+        , matrixMixer(createMatrixMixer(arena, layout.size()))
     {
+        jassert(numChannels <= maxChannels);
+
+        const auto pairs = getChannelPairs(layout);
+
+        if (! pairs.empty()) {
+            leftChannel = pairs.front().first;
+            rightChannel = pairs.front().second;
+        }
+    }
+
+    size_t StageFolder::getArenaBytes(const AudioChannelSet& layout, double, int samplesPerBlock) noexcept {
+        return Arena::sizeFor<StageFolder>() + getMatrixMixerArenaBytes(layout.size(), samplesPerBlock);
+    }
+
+    void StageFolder::prepare(Arena& arena, double, int samplesPerBlock) {
+        matrixMixer->prepare(arena, samplesPerBlock);
+        isFolded = false;
+    }
+
+    bool StageFolder::update(const PreProcessor& pre, const MixerProcessor& mixer, bool preGainsMeetSpectralFx) noexcept {
+        const auto canFold = ! pre.isSmoothing()
+                          && ! mixer.isRamping()
+                          && (! preGainsMeetSpectralFx || pre.getGain(leftChannel) == pre.getGain(rightChannel));
+
+        // settled gains only change through a new ramp, so a fold holds until then
+        if (! canFold) {
+            isFolded = false;
+        } else if (! isFolded) {
+            fold(pre, mixer);
+            isFolded = true;
+        }
+
+        return isFolded;
+    }
+
+    void StageFolder::setQuality(Quality quality) noexcept {
+        const auto newTolerance = quality == Quality::Economy ? identityTolerance : 0.f;
+
+        if (newTolerance != tolerance) {
+            tolerance = newTolerance;
+            isFolded = false;
+        }
+    }
+
+    void StageFolder::fold(const PreProcessor& pre, const MixerProcessor& mixer) noexcept {
+        auto isDiagonal = true;
+        auto isIdentity = true;
+
+        for (int output = 0; output < numChannels; ++output) {
+            for (int input = 0; input < numChannels; ++input) {
+                auto gain = mixer.getGain(input, output) * pre.getGain(input);
+
+                // a step of no more than the tolerance, -60 dB at Economy
+                if (std::abs(gain - (input == output ? 1.f : 0.f)) <= tolerance) {
+                    gain = input == output ? 1.f : 0.f;
+                }
+
+                gains[output][input] = gain;
+
+                matrixMixer->setGain(input, output, gain);
+
+                if (input != output && gain != 0.f) {
+                    isDiagonal = isIdentity = false;
+                } else if (input == output && gain != 1.f) {
+                    isIdentity = false;
+                }
+            }
+        }
+
+        // straight to the folded gains, the full path has already ramped there
+        matrixMixer->reset();
+
+        structure = isIdentity ? Structure::Identity : (isDiagonal ? Structure::Diagonal : Structure::Matrix);
     }
 
-    void FxProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
-        //==============================================================================
-        fxProcessorGraph->setPlayConfigDetails(getMainBusNumInputChannels(),
-                                        getMainBusNumOutputChannels(),
-                                        sampleRate, samplesPerBlock);
-        fxProcessorGraph->prepareToPlay(sampleRate, samplesPerBlock);
-        fxProcessorGraph->clear();
-    
-        //==============================================================================
-        audioInputNode = fxProcessorGraph->addNode(std::make_unique<IOProcessor>(IOProcessor::audioInputNode));
-        leftFxNode = fxProcessorGraph->addNode(std::make_unique<LeftFxUnit>(parameters));
-        rightFxNode = fxProcessorGraph->addNode(std::make_unique<RightFxUnit>(parameters));
-        audioOutputNode = fxProcessorGraph->addNode(std::make_unique<IOProcessor>(IOProcessor::audioOutputNode));
-    
-        // IN.L -> FXL
-        fxProcessorGraph->addConnection({
-            {audioInputNode->nodeID, 0},
-            {leftFxNode->nodeID, 0},
-        });
-
-        // IN.R -> FXR
-        fxProcessorGraph->addConnection({
-            {audioInputNode->nodeID, 1},
-            {rightFxNode->nodeID, 0},
-        });
-
-        // FXL -> OUT.L
-        fxProcessorGraph->addConnection({
-            {leftFxNode->nodeID, 0},
-            {audioOutputNode->nodeID, 0},
-        });
-
-        // FXR -> OUT.R
-        fxProcessorGraph->addConnection({
-            {rightFxNode->nodeID, 0},
-            {audioOutputNode->nodeID, 1},
-        });
-    }
-
-    void FxProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& midiMessages) {
-        ignoreUnused(buffer);
-        
-        fxProcessorGraph->processBlock(buffer, midiMessages);
-    }
-
-    void FxProcessor::reset() {
-        fxProcessorGraph->reset();
-    }
-}
\ No newline at end of file
+    void StageFolder::process(AudioBuffer<float>& buffer) noexcept {
+        jassert(isFolded);
+
+        switch (structure) {
+            case Structure::Identity:
+                break;
+
+            case Structure::Diagonal: {
+                const auto& k = kernels::get();
+
+                for (int ch = 0; ch < numChannels; ++ch) {
+                    if (gains[ch][ch] != 1.f) {
+                        k.multiply(buffer.getWritePointer(ch), gains[ch][ch], buffer.getNumSamples());
+                    }
+                }
+
+                break;
+            }
+
+            case Structure::Matrix:
+                matrixMixer->process(buffer);
+                break;
+        }
+    }
+}
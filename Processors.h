@@ -3,65 +3,65 @@
 #include "juce_core/system/juce_PlatformDefs.h"
 #include <JuceHeader.h>
 #include <atomic>
-#include <atomic>
 #include <cmath>
 #include <memory>
 
-//==============================================================================
-class PantheonProcessorBase  : public juce::AudioProcessor
-{
-public:
-    //==============================================================================
-    PantheonProcessorBase(BusesProperties ioLayouts
-        = BusesProperties().withInput ("Input", juce::AudioChannelSet::stereo())
-                                           .withOutput ("Output", juce::AudioChannelSet::stereo()))
-        : AudioProcessor (ioLayouts)
-    {}
-    //==============================================================================
-    void prepareToPlay (double, int) override {}
-    void releaseResources() override {}
-    void processBlock (juce::AudioSampleBuffer&, juce::MidiBuffer&) override {}
+#include "Arena.h"
+#include "Coefficients.h"
+#include "FxStages.h"
+#include "Kernels.h"
+#include "MatrixMixer.h"
+#include "Parameters.h"
+#include "SpectralShaper.h"
 
+namespace process {
     //==============================================================================
-    juce::AudioProcessorEditor* createEditor() override          { return nullptr; }
-    bool hasEditor() const override                              { return false; }
+    // 7.1.4, the widest layout the plugin accepts
+    static constexpr int maxChannels = 12;
 
     //==============================================================================
-    const juce::String getName() const override                  { return {}; }
-    bool acceptsMidi() const override                            { return false; }
-    bool producesMidi() const override                           { return false; }
-    double getTailLengthSeconds() const override                 { return 0; }
+    // The stages are plain objects created in the plugin's arena. Each reports the
+    // arena bytes it needs, itself included; the object holds the hot per-block
+    // state, and prepare() takes the bulk buffers from the arena behind it.
+    class PreProcessor {
+    public:
+        PreProcessor(const Parameters&, const AudioChannelSet& = AudioChannelSet::stereo());
 
-    //==============================================================================
-    int getNumPrograms() override                                { return 0; }
-    int getCurrentProgram() override                             { return 0; }
-    void setCurrentProgram (int) override                        {}
-    const juce::String getProgramName (int) override             { return {}; }
-    void changeProgramName (int, const juce::String&) override   {}
+        static size_t getArenaBytes(const AudioChannelSet&, double sampleRate, int samplesPerBlock) noexcept;
 
-    //==============================================================================
-    void getStateInformation (juce::MemoryBlock&) override       {}
-    void setStateInformation (const void*, int) override         {}
+        void prepare(Arena&, double sampleRate, int samplesPerBlock);
+        void process(AudioBuffer<float>&) noexcept;
+        void reset() noexcept;
 
-private:
-    //==============================================================================
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PantheonProcessorBase)
-};
+        // for StageFolder: process() does both itself
+        void updateParameter();
+        bool isSmoothing() const noexcept;
+        float getGain(int channel) const noexcept;
 
-namespace process {
-    //==============================================================================
-    class PreProcessor : public PantheonProcessorBase {
-    public:
-        PreProcessor(AudioProcessorValueTreeState&);
-        void prepareToPlay(double, int) override;
-        void processBlock(AudioSampleBuffer&, MidiBuffer&) override;
-        void reset() override;
-        const String getName() const override {return "Pre";}
+        // the front pair's settled gains; see Engine::computeResponse()
+        static void applyResponse(const Parameters&, const CoefficientTables&, ResponseGrid&) noexcept;
     private:
         //==============================================================================
-        AudioProcessorValueTreeState& parameters;
-        std::unique_ptr<dsp::ProcessorChain<dsp::Gain<float>, dsp::Panner<float>>> preProcessorChain;
-        void updateParameter();
+        const Parameters& parameters;
+
+        //==============================================================================
+        // input gain and pan law folded into one smoothed gain per group: the left
+        // and right channels of every pair, and the unpaired channels (centre, LFE)
+        enum GainGroup {
+            LeftGroup = 0,
+            RightGroup,
+            UnpairedGroup,
+            numGainGroups
+        };
+
+        LinearSmoothedValue<float> groupGains[numGainGroups];
+        int groupChannels[numGainGroups][maxChannels] {};
+        int groupSizes[numGainGroups] {};
+        int channelGroups[maxChannels] {};
+        int gainRampLength { 0 };
+
+        SharedResourcePointer<CoefficientTableRegistry> tableRegistry;
+        std::shared_ptr<const CoefficientTables> coefficientTables;
 
         //==============================================================================
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PreProcessor)
@@ -73,214 +73,168 @@ namespace process {
         Right = 1,
     };
 
-    template <Channel SOURCE, Channel TARGET>
-    class MixerUnit : public PantheonProcessorBase {
+    //==============================================================================
+    class MixerProcessor {
     public:
-        MixerUnit(AudioProcessorValueTreeState& apvts)
-            : PantheonProcessorBase(BusesProperties().withInput ("Input", juce::AudioChannelSet::mono())
-                                           .withOutput ("Output", juce::AudioChannelSet::mono()))
-            , parameters(apvts)
-            , gain(new dsp::Gain<float>{})
-        {
-        }
-
-        void prepareToPlay(double sampleRate, int samplesPerBlock) override {
-            gain->setRampDurationSeconds((double)samplesPerBlock / sampleRate);
-            gain->prepare(
-                {sampleRate, (uint32)samplesPerBlock, 1}
-            );
-        }
-
-        void processBlock(AudioSampleBuffer& buffer, MidiBuffer&) override {
-            ScopedNoDenormals noDenormals;
-            
-            updateParameter();
-
-            dsp::AudioBlock<float>block(buffer);
-            dsp::ProcessContextReplacing<float>context(block);
-
-            gain->process(context);
-        }
-
-        void reset() override {
-            gain.reset();
-        }
-
-        const String getName() const override {return "MixerUnit";}
+        // the matrix itself is created in the arena right behind this object
+        MixerProcessor(const Parameters&, Arena&, const AudioChannelSet& = AudioChannelSet::stereo());
+
+        static size_t getArenaBytes(const AudioChannelSet&, double sampleRate, int samplesPerBlock) noexcept;
+
+        void prepare(Arena&, double sampleRate, int samplesPerBlock);
+        void process(AudioBuffer<float>&) noexcept;
+        void reset() noexcept;
+
+        // for StageFolder: process() does both itself
+        void updateParameter();
+        bool isRamping() const noexcept { return matrixMixer->isRamping(); }
+        float getGain(int input, int output) const noexcept { return matrixMixer->getGain(input, output); }
 
+        static void applyResponse(const Parameters&, const CoefficientTables&, ResponseGrid&) noexcept;
     private:
+        const Parameters& parameters;
+
+        //==============================================================================
+        MatrixMixerBase* matrixMixer { nullptr };
+
+        int pairChannels[maxChannels / 2][2] {};
+        int numPairs { 0 };
+        int unpairedChannels[maxChannels] {};
+        int numUnpaired { 0 };
+
         //==============================================================================
-        AudioProcessorValueTreeState& parameters;
-        std::unique_ptr<dsp::Gain<float>> gain;
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MixerProcessor)
+    };
+
+    //==============================================================================
+    class FxProcessor {
+    public:
+        FxProcessor(const Parameters&, const AudioChannelSet& = AudioChannelSet::stereo());
+
+        static size_t getArenaBytes(const AudioChannelSet&, double sampleRate, int samplesPerBlock) noexcept;
+
+        void prepare(Arena&, double sampleRate, int samplesPerBlock);
+        void process(AudioBuffer<float>&) noexcept;
+        void reset() noexcept;
+
+        void setQuality(Quality quality) noexcept { stages.setQuality(quality); }
+
+        static void applyResponse(const Parameters&, const CoefficientTables&, ResponseGrid&) noexcept;
+
+        // the full range of the delayLine parameter
+        static constexpr double maxDelayInMilliseconds { DelayStage::maxDelayInMilliseconds };
+    private:
+        const Parameters& parameters;
 
         //==============================================================================
-        static constexpr const char* directions[4] = {"leftPreGain",
-                                                     "leftToRightGain",
-                                                     "rightToLeftGain",
-                                                     "rightPreGain"};
+        // the stages run on the front left/right pair
+        int leftChannel { 0 };
+        int rightChannel { 1 };
 
-        static constexpr const char* z = directions[(SOURCE << 1) | TARGET];
+        FxStages stages;
 
-        void updateParameter() {
-            const auto gainValue = parameters.getRawParameterValue(z)->load();
-            gain->setGainLinear(gainValue);
-        }
+        //==============================================================================
+        SharedResourcePointer<CoefficientTableRegistry> tableRegistry;
+        std::shared_ptr<const CoefficientTables> coefficientTables;
 
-        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MixerUnit)
+        //==============================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FxProcessor)
     };
 
     //==============================================================================
-    class MixerProcessor : public PantheonProcessorBase {
+    // The spectral alternative to FxProcessor: width, pan and side rotation per
+    // bin on the front pair. Every other channel is delayed to stay aligned.
+    class SpectralProcessor {
     public:
-        MixerProcessor(AudioProcessorValueTreeState&);
-        void prepareToPlay(double, int) override;
-        void processBlock(AudioSampleBuffer&, MidiBuffer&) override;
-        void reset() override;
-        const String getName() const override {return "Mixer";}
+        SpectralProcessor(const Parameters&, const AudioChannelSet& = AudioChannelSet::stereo());
+
+        static size_t getArenaBytes(const AudioChannelSet&, double sampleRate, int samplesPerBlock) noexcept;
+
+        void prepare(Arena&, double sampleRate, int samplesPerBlock);
+        void process(AudioBuffer<float>&) noexcept;
+        void reset() noexcept;
+
+        int getLatencyInSamples() const noexcept { return shaper.getLatencyInSamples(); }
+
+        // caps the overlap at 4 for Reduced, 2 for Economy
+        void setQuality(Quality) noexcept;
+
+        static void applyResponse(const Parameters&, const CoefficientTables&, ResponseGrid&) noexcept;
     private:
-        AudioProcessorValueTreeState& parameters;
+        const Parameters& parameters;
 
         //==============================================================================
-        std::unique_ptr<AudioProcessorGraph> mixerProcessorGraph;
+        int leftChannel { 0 };
+        int rightChannel { 1 };
 
-        using IOProcessor = AudioProcessorGraph::AudioGraphIOProcessor;
-        using Node = AudioProcessorGraph::Node;
+        SpectralShaper shaper;
 
-        Node::Ptr audioInputNode;
+        // fftSize rings for the channels the shaper doesn't touch
+        int otherChannels[maxChannels] {};
+        float* otherDelays[maxChannels] {};
+        int numOtherChannels { 0 };
+        int delayPosition { 0 };
 
-        Node::Ptr leftPreGainUnitNode;
-        Node::Ptr leftToRightGainUnitNode;
-        Node::Ptr rightToLeftGainUnitNode;
-        Node::Ptr rightPreGainUnitNode;
+        int maxOverlap { 8 };
 
-        Node::Ptr audioOutputNode;
+        //==============================================================================
+        SharedResourcePointer<CoefficientTableRegistry> tableRegistry;
+        std::shared_ptr<const CoefficientTables> coefficientTables;
 
         //==============================================================================
-        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MixerProcessor)
+        void updateParameter();
+
+        //==============================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectralProcessor)
     };
 
     //==============================================================================
-    class FxProcessor : public PantheonProcessorBase {
+    // Once the Pre gains and the mixer matrix have settled, folds them into one
+    // matrix, mixer times the diagonal Pre gains, and runs it with the cheapest
+    // kernel for its shape. The diagonal commutes with the per-channel time-domain
+    // Fx, so this holds for either fxPosition; the spectral Fx mixes the front
+    // pair, so before it the fold needs equal gains on that pair. Anything still
+    // ramping sends the block down the full path.
+    class StageFolder {
     public:
-        FxProcessor(AudioProcessorValueTreeState&);
-        void prepareToPlay(double, int) override;
-        void processBlock(AudioSampleBuffer&, MidiBuffer&) override;
-        void reset() override;
-        const String getName() const override {return "Fx";}
-    private:
-        AudioProcessorValueTreeState& parameters;
+        enum class Structure {
+            Identity = 0,       // nothing to do
+            Diagonal,           // one in-place multiply per channel
+            Matrix,             // the full matrix, zero paths skipped
+        };
 
+        StageFolder(Arena&, const AudioChannelSet& = AudioChannelSet::stereo());
 
+        static size_t getArenaBytes(const AudioChannelSet&, double sampleRate, int samplesPerBlock) noexcept;
+
+        void prepare(Arena&, double sampleRate, int samplesPerBlock);
+
+        // call after both stages' updateParameter(); false means take the full path
+        bool update(const PreProcessor&, const MixerProcessor&, bool preGainsMeetSpectralFx) noexcept;
+        void process(AudioBuffer<float>&) noexcept;
+
+        // at Economy, gains within identityTolerance of the identity fold to it
+        void setQuality(Quality) noexcept;
+        static constexpr float identityTolerance = 0.001f;
+
+        Structure getStructure() const noexcept { return structure; }
+    private:
         //==============================================================================
-        template <Channel CHANNEL>
-        class FxUnit : public PantheonProcessorBase {
-        public:
-            FxUnit(AudioProcessorValueTreeState& apvts)
-                : PantheonProcessorBase(BusesProperties().withInput ("Input", juce::AudioChannelSet::mono())
-                                           .withOutput ("Output", juce::AudioChannelSet::mono()))
-                , parameters(apvts)
-                , fxUnitProcessor(new FxProcess{})
-            { 
-            }
-
-            void prepareToPlay(double sampleRate, int samplesPerBlock) override {
-                maxDelayInSamples = samplesPerBlock / 2;
-                _sampleRate = sampleRate;
-                logNyquist = log10(sampleRate / 2);
-
-                delayParamSmoothedValue.reset(samplesPerBlock / 8);
-                filterParamSmoothedValue.reset(samplesPerBlock / 8);
-
-                fxUnitProcessor->prepare({sampleRate, (uint32)samplesPerBlock, 1});
-                fxUnitProcessor->get<0>().setMaximumDelayInSamples(maxDelayInSamples);
-                fxUnitProcessor->get<1>().setType(dsp::FirstOrderTPTFilterType::allpass);
-                fxUnitProcessor->get<1>().setCutoffFrequency((float)sampleRate / two);
-                fxUnitProcessor->get<2>().setType(dsp::FirstOrderTPTFilterType::allpass);
-                fxUnitProcessor->get<2>().setCutoffFrequency((float)sampleRate / two);
-            }
-
-            void processBlock(AudioSampleBuffer& buffer, MidiBuffer&) override {
-                ScopedNoDenormals noDenormals;
-
-                updateParameter();
-
-                dsp::AudioBlock<float>block(buffer);
-                dsp::ProcessContextReplacing<float>context(block);
-
-                fxUnitProcessor->process(context);
-            }
-
-            void reset() override {
-                fxUnitProcessor->reset();
-            }
-
-        private:
-            AudioProcessorValueTreeState& parameters;
-
-            //==============================================================================
-            int maxDelayInSamples { 128 };
-            double _sampleRate { 44100. };
-            double logNyquist { 1. };
-            static constexpr float two { 2.01f };
-
-            //==============================================================================
-            using FxProcess = dsp::ProcessorChain<dsp::DelayLine<float>, dsp::FirstOrderTPTFilter<float>, dsp::FirstOrderTPTFilter<float>>; // this is good, for now
-
-            std::unique_ptr<FxProcess> fxUnitProcessor;
-
-            //==============================================================================
-            LinearSmoothedValue<float> delayParamSmoothedValue;
-            LinearSmoothedValue<float> filterParamSmoothedValue;
-
-            //==============================================================================
-            void updateParameter() {
-                const float delayParam = *parameters.getRawParameterValue("delayLine");
-                const float filterParam = *parameters.getRawParameterValue("allPassFreq");
-
-                delayParamSmoothedValue.setTargetValue(delayParam);
-                filterParamSmoothedValue.setTargetValue(filterParam);
-
-                const auto currentDelayValue = delayParamSmoothedValue.getNextValue();
-                const auto currentFilterValue = filterParamSmoothedValue.getNextValue();
-
-                float delay;
-                float filter;
-
-                if (CHANNEL == Left) {
-                    delay = abs(jlimit(-1.f, 0.f, currentDelayValue)) * static_cast<float>(maxDelayInSamples);
-                    filter = (1.f - abs(jlimit(-1.f, 0.f, currentFilterValue))) * static_cast<float>(logNyquist);
-                } else {
-                    delay = jlimit(0.f, 1.f, currentDelayValue) * static_cast<float>(maxDelayInSamples);
-                    filter = (1.f - jlimit(0.f, 1.f, currentFilterValue)) * static_cast<float>(logNyquist);
-                }
-
-                fxUnitProcessor->get<0>().setDelay(delay);
-                
-                filter = pow(10.f, static_cast<float>(filter));
-                filter = jlimit(10.f, (float)_sampleRate / two, filter);
-                fxUnitProcessor->get<1>().setCutoffFrequency(filter);
-                fxUnitProcessor->get<2>().setCutoffFrequency(filter);
-            }
-
-            //==============================================================================
-            JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FxUnit)
-        };
+        void fold(const PreProcessor&, const MixerProcessor&) noexcept;
 
-        using LeftFxUnit = FxUnit<Left>;
-        using RightFxUnit = FxUnit<Right>;
-        
         //==============================================================================
-        std::unique_ptr<AudioProcessorGraph> fxProcessorGraph;
+        float gains[maxChannels][maxChannels] {};   // [output][input]
+        int numChannels { 0 };
+        int leftChannel { 0 };
+        int rightChannel { 1 };
 
-        using IOProcessor = AudioProcessorGraph::AudioGraphIOProcessor;
-        using Node = AudioProcessorGraph::Node;
+        Structure structure { Structure::Matrix };
+        bool isFolded { false };
+        float tolerance { 0.f };
 
-        Node::Ptr audioInputNode;
-        Node::Ptr leftFxNode;
-        Node::Ptr rightFxNode;
-        Node::Ptr audioOutputNode;
+        MatrixMixerBase* matrixMixer { nullptr };
 
         //==============================================================================
-        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FxProcessor)
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StageFolder)
     };
 }
@@ -0,0 +1,220 @@
+#include "ResponseDisplay.h"
+#include <algorithm>
+
+#include "Engine.h"
+#include "LookAndFeel.h"
+
+ResponseDisplay::ResponseDisplay(AudioPluginAudioProcessor& p, AudioProcessorValueTreeState& apvts)
+    : processorRef(p)
+{
+    for (int i = 0; i < numParameters; ++i) {
+        values[i] = apvts.getRawParameterValue(process::Parameters::getInfo((process::ParameterId)i).id);
+        jassert(values[i] != nullptr);
+    }
+
+    setOpaque(true);
+
+    thread->addTimeSliceClient(this);
+    startTimerHz(30);
+}
+
+ResponseDisplay::~ResponseDisplay() {
+    stopTimer();
+
+    // waits for a running recompute to finish
+    thread->removeTimeSliceClient(this);
+}
+
+//==============================================================================
+bool ResponseDisplay::Request::operator==(const Request& other) const noexcept {
+    return sampleRate == other.sampleRate
+        && numPoints == other.numPoints
+        && std::equal(std::begin(values), std::end(values), std::begin(other.values));
+}
+
+ResponseDisplay::Request ResponseDisplay::makeRequest() const {
+    Request request;
+
+    for (int i = 0; i < numParameters; ++i) {
+        request.values[i] = values[i]->load(std::memory_order_relaxed);
+    }
+
+    // before the first prepareToPlay there's no rate yet
+    const auto sampleRate = processorRef.getSampleRate();
+    request.sampleRate = sampleRate > 0. ? sampleRate : 48000.;
+    request.numPoints = jlimit(2, maxPoints, getWidth() / 2);
+
+    return request;
+}
+
+//==============================================================================
+void ResponseDisplay::timerCallback() {
+    const auto request = makeRequest();
+
+    if (request != lastRequest) {
+        lastRequest = request;
+
+        {
+            const SpinLock::ScopedLockType sl(lock);
+            pending = request;
+            hasRequest = true;
+        }
+
+        thread->moveToFrontOfQueue(this);
+    }
+
+    {
+        const SpinLock::ScopedLockType sl(lock);
+
+        if (! hasCurves) {
+            return;
+        }
+
+        shown = computed;
+        hasCurves = false;
+    }
+
+    updatePaths();
+    repaint();
+}
+
+void ResponseDisplay::updateNow() {
+    // waits for a recompute the timer sent off, and keeps the thread out of this one
+    thread->removeTimeSliceClient(this);
+
+    {
+        const SpinLock::ScopedLockType sl(lock);
+        pending = lastRequest = makeRequest();
+        hasRequest = true;
+    }
+
+    useTimeSlice();
+    thread->addTimeSliceClient(this);
+
+    // picks the curves up and lays out the paths
+    timerCallback();
+}
+
+int ResponseDisplay::useTimeSlice() {
+    Request request;
+
+    {
+        const SpinLock::ScopedLockType sl(lock);
+
+        if (! hasRequest) {
+            return 500;
+        }
+
+        request = pending;
+        hasRequest = false;
+    }
+
+    for (int i = 0; i < numParameters; ++i) {
+        snapshot.set((process::ParameterId)i, request.values[i]);
+    }
+
+    const auto tables = tableRegistry->get(request.sampleRate);
+
+    grid.reset(request.sampleRate, request.numPoints);
+    process::Engine::computeResponse(snapshot, *tables, grid);
+
+    working.numPoints = grid.getNumPoints();
+
+    for (int point = 0; point < working.numPoints; ++point) {
+        working.frequencies[point] = grid.getFrequency(point);
+        working.phaseDifferences[point] = grid.getPhaseDifference(point);
+
+        for (int ch = 0; ch < 2; ++ch) {
+            working.decibels[ch][point] = Decibels::gainToDecibels(grid.getMagnitude(ch, point), 2.f * minimumDecibels);
+        }
+    }
+
+    {
+        const SpinLock::ScopedLockType sl(lock);
+        computed = working;
+        hasCurves = true;
+    }
+
+    return 500;
+}
+
+//==============================================================================
+float ResponseDisplay::getX(float frequency) const noexcept {
+    // the last point sits at the top of the grid's range
+    const auto top = shown.numPoints > 1 ? shown.frequencies[shown.numPoints - 1] : process::ResponseGrid::maximumFrequency;
+    const auto position = std::log(frequency / process::ResponseGrid::minimumFrequency)
+                        / std::log(top / process::ResponseGrid::minimumFrequency);
+
+    return position * (float)getWidth();
+}
+
+void ResponseDisplay::updatePaths() {
+    leftPath.clear();
+    rightPath.clear();
+    phasePath.clear();
+
+    const auto height = (float)getHeight();
+
+    const auto decibelsToY = [height](float decibels) {
+        return jmap(jlimit(minimumDecibels, maximumDecibels, decibels), maximumDecibels, minimumDecibels, 0.f, height);
+    };
+
+    // the phase difference uses the full height, 0 in the middle
+    const auto phaseToY = [height](float phase) {
+        return jmap(phase, MathConstants<float>::pi, -MathConstants<float>::pi, 0.f, height);
+    };
+
+    for (int point = 0; point < shown.numPoints; ++point) {
+        const auto x = getX(shown.frequencies[point]);
+        const Point<float> left { x, decibelsToY(shown.decibels[0][point]) };
+        const Point<float> right { x, decibelsToY(shown.decibels[1][point]) };
+        const Point<float> phase { x, phaseToY(shown.phaseDifferences[point]) };
+
+        if (point == 0) {
+            leftPath.startNewSubPath(left);
+            rightPath.startNewSubPath(right);
+            phasePath.startNewSubPath(phase);
+            continue;
+        }
+
+        leftPath.lineTo(left);
+        rightPath.lineTo(right);
+
+        // no line across a wrap from +pi to -pi
+        if (std::abs(shown.phaseDifferences[point] - shown.phaseDifferences[point - 1]) > MathConstants<float>::pi) {
+            phasePath.startNewSubPath(phase);
+        } else {
+            phasePath.lineTo(phase);
+        }
+    }
+}
+
+void ResponseDisplay::paint(Graphics& g) {
+    g.fillAll(getLookAndFeel().findColour(ResizableWindow::backgroundColourId));
+
+    const auto bounds = getLocalBounds().toFloat();
+
+    // decades and 0 dB
+    g.setColour(Colours::linen.withAlpha(0.15f));
+
+    for (auto frequency : {100.f, 1000.f, 10000.f}) {
+        g.drawVerticalLine(roundToInt(getX(frequency)), bounds.getY(), bounds.getBottom());
+    }
+
+    const auto zero = jmap(0.f, maximumDecibels, minimumDecibels, 0.f, bounds.getHeight());
+    g.drawHorizontalLine(roundToInt(zero), bounds.getX(), bounds.getRight());
+
+    g.setColour(Colours::linen.withAlpha(0.5f));
+    g.strokePath(phasePath, PathStrokeType(1.f));
+
+    g.setColour(PanLook::leftColour);
+    g.strokePath(leftPath, PathStrokeType(1.5f));
+
+    g.setColour(PanLook::rightColour);
+    g.strokePath(rightPath, PathStrokeType(1.5f));
+}
+
+void ResponseDisplay::resized() {
+    // the point count follows the width, the timer picks the change up
+    updatePaths();
+}
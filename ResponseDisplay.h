@@ -0,0 +1,95 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "Coefficients.h"
+#include "DelayAligner.h"
+#include "Parameters.h"
+#include "PluginProcessor.h"
+#include "ResponseGrid.h"
+
+//==============================================================================
+// Magnitude of both channels and their phase difference against frequency, for
+// a mono input through the chain as the parameters stand, the mixer included.
+// The curves are computed from the coefficients, not measured: a timer compares
+// the parameter values with the ones last sent off, and only on a change does
+// the shared analysis thread recompute them. A point every two pixels, capped
+// at ResponseGrid::maxPoints, keeps the cost of both the recompute and a
+// repaint bounded up to the editor's maximum size.
+class ResponseDisplay : public Component, private Timer, private TimeSliceClient
+{
+public:
+    ResponseDisplay(AudioPluginAudioProcessor&, AudioProcessorValueTreeState&);
+    ~ResponseDisplay() override;
+
+    void paint(Graphics&) override;
+    void resized() override;
+
+    // a timer tick with the recompute done on the calling thread; for the
+    // headless GUI bench, where the timer doesn't run
+    void updateNow();
+
+private:
+    //==============================================================================
+    static constexpr int numParameters = process::Parameters::numParameters;
+    static constexpr int maxPoints = process::ResponseGrid::maxPoints;
+
+    static constexpr float minimumDecibels = -24.f;
+    static constexpr float maximumDecibels = 12.f;
+
+    struct Request {
+        float values[numParameters] {};
+        double sampleRate { 0. };
+        int numPoints { 0 };
+
+        bool operator==(const Request&) const noexcept;
+        bool operator!=(const Request& other) const noexcept { return ! (*this == other); }
+    };
+
+    struct Curves {
+        int numPoints { 0 };
+        float frequencies[maxPoints] {};
+        float decibels[2][maxPoints] {};
+        float phaseDifferences[maxPoints] {};
+    };
+
+    //==============================================================================
+    void timerCallback() override;
+    int useTimeSlice() override;
+
+    Request makeRequest() const;
+    void updatePaths();
+
+    float getX(float frequency) const noexcept;
+
+    //==============================================================================
+    AudioPluginAudioProcessor& processorRef;
+
+    // the apvts values, by ParameterId
+    std::atomic<float>* values[numParameters] {};
+
+    // message thread
+    Request lastRequest;
+    Curves shown;
+    Path leftPath;
+    Path rightPath;
+    Path phasePath;
+
+    // handed over between the threads
+    SpinLock lock;
+    Request pending;
+    Curves computed;
+    bool hasRequest { false };
+    bool hasCurves { false };
+
+    // analysis thread
+    process::Parameters snapshot;
+    process::ResponseGrid grid;
+    Curves working;
+
+    SharedResourcePointer<process::CoefficientTableRegistry> tableRegistry;
+    SharedResourcePointer<process::AnalysisThread> thread;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ResponseDisplay)
+};
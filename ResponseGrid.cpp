@@ -0,0 +1,170 @@
+#include "ResponseGrid.h"
+#include <cmath>
+
+namespace process {
+    //==============================================================================
+    void ResponseGrid::reset(double newSampleRate, int newNumPoints) noexcept {
+        jassert(newSampleRate > 0.);
+
+        newNumPoints = jlimit(2, maxPoints, newNumPoints);
+
+        // the frequencies only move with the sample rate or the point count
+        const auto resized = newNumPoints != numPoints || newSampleRate != sampleRate;
+
+        sampleRate = newSampleRate;
+        numPoints = newNumPoints;
+
+        if (resized) {
+            const auto top = jmin(maximumFrequency, (float)(0.5 * sampleRate));
+            const auto ratio = std::log(top / minimumFrequency);
+
+            for (int point = 0; point < numPoints; ++point) {
+                const auto frequency = minimumFrequency * std::exp(ratio * (float)point / (float)(numPoints - 1));
+
+                frequencies[point] = frequency;
+                omegas[point] = MathConstants<float>::twoPi * frequency / (float)sampleRate;
+                cosines[point] = std::cos(omegas[point]);
+                sines[point] = std::sin(omegas[point]);
+            }
+        }
+
+        for (int ch = 0; ch < 2; ++ch) {
+            std::fill(real[ch], real[ch] + numPoints, 1.f);
+            std::fill(imag[ch], imag[ch] + numPoints, 0.f);
+        }
+    }
+
+    //==============================================================================
+    void ResponseGrid::multiplyGains(float left, float right) noexcept {
+        FloatVectorOperations::multiply(real[0], left, numPoints);
+        FloatVectorOperations::multiply(imag[0], left, numPoints);
+        FloatVectorOperations::multiply(real[1], right, numPoints);
+        FloatVectorOperations::multiply(imag[1], right, numPoints);
+    }
+
+    void ResponseGrid::mix(float leftToLeft, float leftToRight, float rightToLeft, float rightToRight) noexcept {
+        auto* lr = real[0];
+        auto* li = imag[0];
+        auto* rr = real[1];
+        auto* ri = imag[1];
+
+        for (int point = 0; point < numPoints; ++point) {
+            const auto inLr = lr[point];
+            const auto inLi = li[point];
+            const auto inRr = rr[point];
+            const auto inRi = ri[point];
+
+            lr[point] = leftToLeft * inLr + rightToLeft * inRr;
+            li[point] = leftToLeft * inLi + rightToLeft * inRi;
+            rr[point] = leftToRight * inLr + rightToRight * inRr;
+            ri[point] = leftToRight * inLi + rightToRight * inRi;
+        }
+    }
+
+    void ResponseGrid::multiplyDelay(int channel, int delayInSamples) noexcept {
+        jassert(isPositiveAndBelow(channel, 2));
+
+        if (delayInSamples == 0) {
+            return;
+        }
+
+        auto* yr = real[channel];
+        auto* yi = imag[channel];
+
+        for (int point = 0; point < numPoints; ++point) {
+            const auto angle = omegas[point] * (float)delayInSamples;
+            const auto hr = std::cos(angle);
+            const auto hi = -std::sin(angle);
+
+            const auto r = yr[point] * hr - yi[point] * hi;
+            yi[point] = yr[point] * hi + yi[point] * hr;
+            yr[point] = r;
+        }
+    }
+
+    void ResponseGrid::multiplyFirstOrder(int channel, float b0, float b1, float a1) noexcept {
+        jassert(isPositiveAndBelow(channel, 2));
+
+        auto* yr = real[channel];
+        auto* yi = imag[channel];
+
+        for (int point = 0; point < numPoints; ++point) {
+            const auto c = cosines[point];
+            const auto s = sines[point];
+
+            const auto nr = b0 + b1 * c;
+            const auto ni = -b1 * s;
+            const auto dr = 1.f + a1 * c;
+            const auto di = -a1 * s;
+
+            // N / D = N * conj(D) / |D|^2
+            const auto norm = 1.f / (dr * dr + di * di);
+            const auto hr = (nr * dr + ni * di) * norm;
+            const auto hi = (ni * dr - nr * di) * norm;
+
+            const auto r = yr[point] * hr - yi[point] * hi;
+            yi[point] = yr[point] * hi + yi[point] * hr;
+            yr[point] = r;
+        }
+    }
+
+    void ResponseGrid::multiplyFir(int channel, const float* b, int numTaps) noexcept {
+        jassert(isPositiveAndBelow(channel, 2));
+
+        auto* yr = real[channel];
+        auto* yi = imag[channel];
+
+        for (int point = 0; point < numPoints; ++point) {
+            auto hr = b[0];
+            auto hi = 0.f;
+
+            for (int tap = 1; tap < numTaps; ++tap) {
+                const auto angle = omegas[point] * (float)tap;
+                hr += b[tap] * std::cos(angle);
+                hi -= b[tap] * std::sin(angle);
+            }
+
+            const auto r = yr[point] * hr - yi[point] * hi;
+            yi[point] = yr[point] * hi + yi[point] * hr;
+            yr[point] = r;
+        }
+    }
+
+    void ResponseGrid::shapeMidSide(const float* sideReal, const float* sideImag, const float* panLeft, const float* panRight) noexcept {
+        auto* lr = real[0];
+        auto* li = imag[0];
+        auto* rr = real[1];
+        auto* ri = imag[1];
+
+        for (int point = 0; point < numPoints; ++point) {
+            const auto mr = 0.5f * (lr[point] + rr[point]);
+            const auto mi = 0.5f * (li[point] + ri[point]);
+            const auto dr = 0.5f * (lr[point] - rr[point]);
+            const auto di = 0.5f * (li[point] - ri[point]);
+
+            const auto sr = dr * sideReal[point] - di * sideImag[point];
+            const auto si = dr * sideImag[point] + di * sideReal[point];
+
+            lr[point] = (mr + sr) * panLeft[point];
+            li[point] = (mi + si) * panLeft[point];
+            rr[point] = (mr - sr) * panRight[point];
+            ri[point] = (mi - si) * panRight[point];
+        }
+    }
+
+    //==============================================================================
+    float ResponseGrid::getMagnitude(int channel, int point) const noexcept {
+        jassert(isPositiveAndBelow(channel, 2) && isPositiveAndBelow(point, numPoints));
+        return std::hypot(real[channel][point], imag[channel][point]);
+    }
+
+    float ResponseGrid::getPhaseDifference(int point) const noexcept {
+        jassert(isPositiveAndBelow(point, numPoints));
+
+        // left * conj(right)
+        const auto r = real[0][point] * real[1][point] + imag[0][point] * imag[1][point];
+        const auto i = imag[0][point] * real[1][point] - real[0][point] * imag[1][point];
+
+        return std::atan2(i, r);
+    }
+}
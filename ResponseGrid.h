@@ -0,0 +1,72 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace process {
+    //==============================================================================
+    // The front pair's frequency response at a set of log-spaced points, for a
+    // mono input. Values are split complex, one array entry per point, and every
+    // factor is a flat loop over those arrays: plain float arithmetic, division
+    // included, so the compiler vectorises each loop across points (SIMDRegister
+    // has no divide). The stages multiply their factors in, in processing order.
+    class ResponseGrid {
+    public:
+        static constexpr int maxPoints = 512;
+        static constexpr float minimumFrequency = 20.f;
+        static constexpr float maximumFrequency = 20000.f;
+
+        ResponseGrid() = default;
+
+        // numPoints from minimumFrequency up to maximumFrequency or nyquist, with
+        // the same unit input on both channels
+        void reset(double sampleRate, int numPoints) noexcept;
+
+        double getSampleRate() const noexcept { return sampleRate; }
+        int getNumPoints() const noexcept { return numPoints; }
+        float getFrequency(int point) const noexcept { return frequencies[point]; }
+
+        //==============================================================================
+        void multiplyGains(float left, float right) noexcept;
+
+        // gains are input to output, as in MatrixMixerBase::setGain
+        void mix(float leftToLeft, float leftToRight, float rightToLeft, float rightToRight) noexcept;
+
+        // z^-delayInSamples
+        void multiplyDelay(int channel, int delayInSamples) noexcept;
+
+        // (b0 + b1 z^-1) / (1 + a1 z^-1)
+        void multiplyFirstOrder(int channel, float b0, float b1, float a1) noexcept;
+
+        // b[0] + b[1] z^-1 + ... + b[numTaps - 1] z^-(numTaps - 1)
+        void multiplyFir(int channel, const float* b, int numTaps) noexcept;
+
+        // SpectralShaper's per-bin mix, one entry per point: mid plus the side
+        // scaled by the complex side gain on the left, minus it on the right,
+        // each channel then scaled by its pan gain
+        void shapeMidSide(const float* sideReal, const float* sideImag, const float* panLeft, const float* panRight) noexcept;
+
+        //==============================================================================
+        float getMagnitude(int channel, int point) const noexcept;
+
+        // arg(left / right) in radians, within [-pi, pi]
+        float getPhaseDifference(int point) const noexcept;
+
+    private:
+        //==============================================================================
+        double sampleRate { 0. };
+        int numPoints { 0 };
+
+        float frequencies[maxPoints] {};
+        float omegas[maxPoints] {};
+
+        // z^-1 = cos w - j sin w
+        float cosines[maxPoints] {};
+        float sines[maxPoints] {};
+
+        float real[2][maxPoints] {};
+        float imag[2][maxPoints] {};
+
+        //==============================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ResponseGrid)
+    };
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <memory>
+
+//==============================================================================
+// Keyed, reference-counted store of read-only resources. Wrap it in a
+// SharedResourcePointer so every plugin instance in the host process sees the
+// same registry; a resource lives for as long as some instance holds it.
+template <typename Key, typename Resource>
+class SharedResourceRegistry {
+public:
+    SharedResourceRegistry() = default;
+
+    template <typename Factory>
+    std::shared_ptr<const Resource> getOrCreate(const Key& key, Factory&& create) {
+        const ScopedLock sl(lock);
+
+        auto& slot = resources[key];
+
+        if (auto existing = slot.lock()) {
+            return existing;
+        }
+
+        std::shared_ptr<const Resource> created { create() };
+        slot = created;
+
+        return created;
+    }
+
+    size_t getNumLiveResources() const {
+        const ScopedLock sl(lock);
+
+        size_t live = 0;
+
+        for (const auto& resource : resources) {
+            live += resource.second.expired() ? 0 : 1;
+        }
+
+        return live;
+    }
+
+private:
+    //==============================================================================
+    CriticalSection lock;
+    std::map<Key, std::weak_ptr<const Resource>> resources;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SharedResourceRegistry)
+};
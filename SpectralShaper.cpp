@@ -0,0 +1,267 @@
+#include "SpectralShaper.h"
+
+namespace process {
+    //==============================================================================
+    static constexpr int fftMask = SpectralShaper::fftSize - 1;
+
+    size_t SpectralShaper::getArenaBytes() noexcept {
+        return 5 * Arena::sizeFor<float>(numPaddedBins)         // bin curves and positions
+             + 4 * Arena::sizeFor<float>(numPaddedBins)         // split re/im per channel
+             + 2 * Arena::sizeFor<float>(2 * fftSize)           // FFT frames
+             + 5 * Arena::sizeFor<float>(fftSize)               // input, overlap-add and window-sum rings
+             + 2 * Arena::sizeFor<float>(fftSize);              // windows
+    }
+
+    void SpectralShaper::prepare(Arena& arena, const CoefficientTables& newTables) {
+        fft = fftRegistry->get(fftOrder);
+        tables = &newTables;
+
+        // hot per-frame data first, in the order processFrame walks it
+        sideCos = arena.take<float>(numPaddedBins);
+        sideSin = arena.take<float>(numPaddedBins);
+        panLeft = arena.take<float>(numPaddedBins);
+        panRight = arena.take<float>(numPaddedBins);
+
+        for (int ch = 0; ch < 2; ++ch) {
+            real[ch] = arena.take<float>(numPaddedBins);
+            imag[ch] = arena.take<float>(numPaddedBins);
+        }
+
+        for (int ch = 0; ch < 2; ++ch) {
+            frames[ch] = arena.take<float>(2 * fftSize);
+            inputs[ch] = arena.take<float>(fftSize);
+            outputs[ch] = arena.take<float>(fftSize);
+        }
+
+        windowSums = arena.take<float>(fftSize);
+        analysisWindow = arena.take<float>(fftSize);
+        squaredWindow = arena.take<float>(fftSize);
+        binPosition = arena.take<float>(numPaddedBins);
+
+        // periodic sqrt-Hann, used again for synthesis
+        for (int i = 0; i < fftSize; ++i) {
+            squaredWindow[i] = 0.5f - 0.5f * std::cos(MathConstants<float>::twoPi * (float)i / (float)fftSize);
+            analysisWindow[i] = std::sqrt(squaredWindow[i]);
+        }
+
+        for (int bin = 0; bin < numBins; ++bin) {
+            const auto frequency = (double)bin * tables->getSampleRate() / (double)fftSize;
+            binPosition[bin] = getCurvePosition(frequency, tables->getSampleRate());
+        }
+
+        overlap = pendingOverlap;
+        applyOverlap();
+
+        // the bin positions moved with the sample rate
+        curvesNeedUpdate = true;
+        setCurves(widthCurve, panCurve, panLaw, rotationCurve);
+
+        reset();
+    }
+
+    void SpectralShaper::reset() noexcept {
+        for (int ch = 0; ch < 2; ++ch) {
+            if (inputs[ch] != nullptr) {
+                FloatVectorOperations::clear(inputs[ch], fftSize);
+                FloatVectorOperations::clear(outputs[ch], fftSize);
+            }
+        }
+
+        if (windowSums != nullptr) {
+            FloatVectorOperations::clear(windowSums, fftSize);
+        }
+
+        position = 0;
+        hopCounter = 0;
+    }
+
+    void SpectralShaper::setOverlap(int newOverlap) noexcept {
+        jassert(newOverlap == 2 || newOverlap == 4 || newOverlap == 8);
+        pendingOverlap = jlimit(2, 8, nextPowerOfTwo(newOverlap));
+    }
+
+    void SpectralShaper::applyOverlap() noexcept {
+        // the frames already laid down keep their place in windowSums, so the
+        // output stays at unity gain while they are played out
+        hopSize = fftSize / overlap;
+    }
+
+    void SpectralShaper::setCurves(Curve width, Curve pan, PanLaw law, Curve rotation) noexcept {
+        if (! curvesNeedUpdate && width == widthCurve && pan == panCurve && law == panLaw && rotation == rotationCurve) {
+            return;
+        }
+
+        curvesNeedUpdate = false;
+
+        widthCurve = width;
+        panCurve = pan;
+        panLaw = law;
+        rotationCurve = rotation;
+
+        for (int bin = 0; bin < numBins; ++bin) {
+            const auto p = binPosition[bin];
+            const auto side = width.low + p * (width.high - width.low);
+            const auto angle = rotation.low + p * (rotation.high - rotation.low);
+
+            sideCos[bin] = side * std::cos(angle);
+            sideSin[bin] = side * std::sin(angle);
+
+            tables->getPanGains(law, pan.low + p * (pan.high - pan.low), panLeft[bin], panRight[bin]);
+        }
+    }
+
+    float SpectralShaper::getCurvePosition(double frequency, double sampleRate) noexcept {
+        const auto range = std::log2(0.5 * sampleRate / 20.);
+        return frequency > 20. ? (float)jlimit(0., 1., std::log2(frequency / 20.) / range) : 0.f;
+    }
+
+    void SpectralShaper::applyResponse(ResponseGrid& grid, const CoefficientTables& tables, Curve width, Curve pan, PanLaw law, Curve rotation) noexcept {
+        float sideReal[ResponseGrid::maxPoints];
+        float sideImag[ResponseGrid::maxPoints];
+        float panLeft[ResponseGrid::maxPoints];
+        float panRight[ResponseGrid::maxPoints];
+
+        // as setCurves(), per point instead of per bin
+        for (int point = 0; point < grid.getNumPoints(); ++point) {
+            const auto p = getCurvePosition(grid.getFrequency(point), tables.getSampleRate());
+            const auto side = width.low + p * (width.high - width.low);
+            const auto angle = rotation.low + p * (rotation.high - rotation.low);
+
+            sideReal[point] = side * std::cos(angle);
+            sideImag[point] = side * std::sin(angle);
+
+            tables.getPanGains(law, pan.low + p * (pan.high - pan.low), panLeft[point], panRight[point]);
+        }
+
+        grid.shapeMidSide(sideReal, sideImag, panLeft, panRight);
+    }
+
+    //==============================================================================
+    void SpectralShaper::process(float* left, float* right, int numSamples) noexcept {
+        float* io[2] = {left, right};
+
+        for (int done = 0; done < numSamples;) {
+            const auto chunk = jmin(numSamples - done, hopSize - hopCounter, fftSize - position);
+
+            for (int ch = 0; ch < 2; ++ch) {
+                FloatVectorOperations::copy(inputs[ch] + position, io[ch] + done, chunk);
+            }
+
+            // slots ahead of the first frame after a reset have no window and no signal either
+            for (int i = 0; i < chunk; ++i) {
+                const auto gain = 1.f / jmax(windowSums[position + i], 1.0e-6f);
+
+                left[done + i] = outputs[0][position + i] * gain;
+                right[done + i] = outputs[1][position + i] * gain;
+            }
+
+            for (int ch = 0; ch < 2; ++ch) {
+                FloatVectorOperations::clear(outputs[ch] + position, chunk);
+            }
+
+            FloatVectorOperations::clear(windowSums + position, chunk);
+
+            position = (position + chunk) & fftMask;
+            hopCounter += chunk;
+            done += chunk;
+
+            if (hopCounter == hopSize) {
+                hopCounter = 0;
+                processFrame();
+
+                if (pendingOverlap != overlap) {
+                    overlap = pendingOverlap;
+                    applyOverlap();
+                }
+            }
+        }
+    }
+
+    //==============================================================================
+    // position is the oldest input sample, and the output slot due next
+    void SpectralShaper::processFrame() noexcept {
+        const auto head = fftSize - position;
+
+        for (int ch = 0; ch < 2; ++ch) {
+            auto* frame = frames[ch];
+
+            FloatVectorOperations::multiply(frame, inputs[ch] + position, analysisWindow, head);
+            FloatVectorOperations::multiply(frame + head, inputs[ch], analysisWindow + head, position);
+
+            fft->performRealOnlyForwardTransform(frame, true);
+
+            for (int bin = 0; bin < numBins; ++bin) {
+                real[ch][bin] = frame[2 * bin];
+                imag[ch][bin] = frame[2 * bin + 1];
+            }
+        }
+
+        shapeBins();
+
+        for (int ch = 0; ch < 2; ++ch) {
+            auto* frame = frames[ch];
+
+            for (int bin = 0; bin < numBins; ++bin) {
+                frame[2 * bin] = real[ch][bin];
+                frame[2 * bin + 1] = imag[ch][bin];
+            }
+
+            fft->performRealOnlyInverseTransform(frame);
+
+            // JUCE's inverse is already scaled by 1 / fftSize
+            FloatVectorOperations::addWithMultiply(outputs[ch] + position, frame, analysisWindow, head);
+            FloatVectorOperations::addWithMultiply(outputs[ch], frame + head, analysisWindow + head, position);
+        }
+
+        FloatVectorOperations::add(windowSums + position, squaredWindow, head);
+        FloatVectorOperations::add(windowSums, squaredWindow + head, position);
+    }
+
+    // m = (l + r) / 2, s = (l - r) / 2 * g * e^(j * angle), l' = pl * (m + s), r' = pr * (m - s)
+    void SpectralShaper::shapeBins() noexcept {
+       #if JUCE_USE_SIMD
+        const auto half = Register::expand(0.5f);
+
+        for (int bin = 0; bin < numPaddedBins; bin += binStep) {
+            const auto lr = Register::fromRawArray(real[0] + bin);
+            const auto li = Register::fromRawArray(imag[0] + bin);
+            const auto rr = Register::fromRawArray(real[1] + bin);
+            const auto ri = Register::fromRawArray(imag[1] + bin);
+
+            const auto mr = (lr + rr) * half;
+            const auto mi = (li + ri) * half;
+            const auto dr = (lr - rr) * half;
+            const auto di = (li - ri) * half;
+
+            const auto c = Register::fromRawArray(sideCos + bin);
+            const auto s = Register::fromRawArray(sideSin + bin);
+
+            const auto sr = dr * c - di * s;
+            const auto si = dr * s + di * c;
+
+            const auto pl = Register::fromRawArray(panLeft + bin);
+            const auto pr = Register::fromRawArray(panRight + bin);
+
+            ((mr + sr) * pl).copyToRawArray(real[0] + bin);
+            ((mi + si) * pl).copyToRawArray(imag[0] + bin);
+            ((mr - sr) * pr).copyToRawArray(real[1] + bin);
+            ((mi - si) * pr).copyToRawArray(imag[1] + bin);
+        }
+       #else
+        for (int bin = 0; bin < numBins; ++bin) {
+            const auto mr = 0.5f * (real[0][bin] + real[1][bin]);
+            const auto mi = 0.5f * (imag[0][bin] + imag[1][bin]);
+            const auto dr = 0.5f * (real[0][bin] - real[1][bin]);
+            const auto di = 0.5f * (imag[0][bin] - imag[1][bin]);
+
+            const auto sr = dr * sideCos[bin] - di * sideSin[bin];
+            const auto si = dr * sideSin[bin] + di * sideCos[bin];
+
+            real[0][bin] = (mr + sr) * panLeft[bin];
+            imag[0][bin] = (mi + si) * panLeft[bin];
+            real[1][bin] = (mr - sr) * panRight[bin];
+            imag[1][bin] = (mi - si) * panRight[bin];
+        }
+       #endif
+    }
+}
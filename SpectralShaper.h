@@ -0,0 +1,131 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+
+#include "Arena.h"
+#include "Coefficients.h"
+#include "ResponseGrid.h"
+#include "SharedResources.h"
+
+namespace process {
+    //==============================================================================
+    // FFT engines are read-only once built, so every instance shares one per order.
+    class FftRegistry : public SharedResourceRegistry<int, dsp::FFT> {
+    public:
+        std::shared_ptr<const dsp::FFT> get(int order) {
+            return getOrCreate(order, [order] { return std::make_shared<dsp::FFT>(order); });
+        }
+    };
+
+    //==============================================================================
+    // Stereo STFT with sqrt-Hann analysis/synthesis windows and overlap-add,
+    // divided by the running sum of the squared windows laid down. Each
+    // frame goes to mid/side per bin, the side is scaled and rotated, and the
+    // result is panned back to left/right, all along log-frequency curves from
+    // the lowest bin to nyquist. Bins are kept as split re/im arrays so the
+    // complex math runs a SIMD register of bins at a time. The output lags the
+    // input by one FFT size.
+    //
+    // NOTE: the window sum is only constant while the hop is; across an overlap
+    // change old and new frames overlap unevenly for one FFT size, and without
+    // the division the level dips or swells by up to ~6 dB over those ~43 ms.
+    class SpectralShaper {
+    public:
+        static constexpr int fftOrder = 11;
+        static constexpr int fftSize = 1 << fftOrder;
+        static constexpr int numBins = fftSize / 2 + 1;
+
+        // a value at the lowest and at the highest bin
+        struct Curve {
+            float low { 0.f };
+            float high { 0.f };
+
+            bool operator==(const Curve& other) const noexcept { return low == other.low && high == other.high; }
+            bool operator!=(const Curve& other) const noexcept { return ! (*this == other); }
+        };
+
+        SpectralShaper() = default;
+
+        static size_t getArenaBytes() noexcept;
+
+        void prepare(Arena&, const CoefficientTables&);
+        void reset() noexcept;
+
+        // 2, 4 or 8 frames per FFT size; takes over at the next frame boundary, without a level change
+        void setOverlap(int newOverlap) noexcept;
+        int getLatencyInSamples() const noexcept { return fftSize; }
+
+        // side gain, pan and side rotation in radians; bins are only rebuilt on a change
+        void setCurves(Curve width, Curve pan, PanLaw, Curve rotation) noexcept;
+
+        void process(float* left, float* right, int numSamples) noexcept;
+
+        // the per-bin mix setCurves() sets up, at the grid's frequencies; the
+        // latency is common to both channels and left out
+        static void applyResponse(ResponseGrid&, const CoefficientTables&, Curve width, Curve pan, PanLaw, Curve rotation) noexcept;
+
+    private:
+        //==============================================================================
+        // where a frequency sits along the curves: 0 at 20 Hz and below, 1 at
+        // nyquist, log-spaced in between
+        static float getCurvePosition(double frequency, double sampleRate) noexcept;
+
+        //==============================================================================
+       #if JUCE_USE_SIMD
+        using Register = dsp::SIMDRegister<float>;
+        static constexpr int binStep = (int)Register::SIMDNumElements;
+       #else
+        static constexpr int binStep = 1;
+       #endif
+
+        // padded so the SIMD loop never needs a scalar tail
+        static constexpr int numPaddedBins = (numBins + 15) & ~15;
+
+        //==============================================================================
+        void processFrame() noexcept;
+        void shapeBins() noexcept;
+        void applyOverlap() noexcept;
+
+        //==============================================================================
+        std::shared_ptr<const dsp::FFT> fft;
+        const CoefficientTables* tables { nullptr };
+
+        int position { 0 };
+        int hopCounter { 0 };
+        int hopSize { fftSize / 4 };
+        int overlap { 4 };
+        int pendingOverlap { 4 };
+
+        Curve widthCurve { 1.f, 1.f };
+        Curve panCurve;
+        Curve rotationCurve;
+        PanLaw panLaw { PanLaw::Minus3dB };
+        bool curvesNeedUpdate { true };
+
+        // per bin: side gain * cos/sin of the rotation, left/right pan gains
+        float* sideCos { nullptr };
+        float* sideSin { nullptr };
+        float* panLeft { nullptr };
+        float* panRight { nullptr };
+        float* binPosition { nullptr };
+
+        float* real[2] {};
+        float* imag[2] {};
+
+        float* frames[2] {};
+        float* inputs[2] {};
+        float* outputs[2] {};
+
+        // the overlap-added window^2 per output slot, common to both channels
+        float* windowSums { nullptr };
+
+        float* analysisWindow { nullptr };
+        float* squaredWindow { nullptr };
+
+        SharedResourcePointer<FftRegistry> fftRegistry;
+
+        //==============================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectralShaper)
+    };
+}
@@ -0,0 +1,76 @@
+#include <JuceHeader.h>
+
+#if JucePlugin_Build_Standalone && JUCE_USE_CUSTOM_PLUGIN_STANDALONE_APP
+
+#include <juce_audio_plugin_client/Standalone/juce_StandaloneFilterWindow.h>
+
+#include "Headless.h"
+
+//==============================================================================
+// JUCE's standalone app, plus the headless command-line modes from Headless.h.
+class PantheonStandaloneApp : public JUCEApplication {
+public:
+    PantheonStandaloneApp() {
+        PropertiesFile::Options options;
+        options.applicationName = getApplicationName();
+        options.filenameSuffix = ".settings";
+        options.osxLibrarySubFolder = "Application Support";
+#if JUCE_LINUX || JUCE_BSD
+        options.folderName = "~/.config";
+#endif
+        appProperties.setStorageParameters(options);
+
+        headless::addCommands(commands);
+    }
+
+    const String getApplicationName() override { return CharPointer_UTF8(JucePlugin_Name); }
+    const String getApplicationVersion() override { return JucePlugin_VersionString; }
+    bool moreThanOneInstanceAllowed() override { return true; }
+    void anotherInstanceStarted(const String&) override {}
+
+    void initialise(const String&) override {
+        const ArgumentList args(getApplicationName(), getCommandLineParameterArray());
+
+        if (commands.findCommand(args, false) != nullptr) {
+            setApplicationReturnValue(commands.findAndRunCommand(args));
+            quit();
+            return;
+        }
+
+        const auto background = LookAndFeel::getDefaultLookAndFeel().findColour(ResizableWindow::backgroundColourId);
+        mainWindow.reset(new StandaloneFilterWindow(getApplicationName(), background, appProperties.getUserSettings(), false, {}, nullptr, {}));
+        mainWindow->setVisible(true);
+    }
+
+    void shutdown() override {
+        mainWindow = nullptr;
+        appProperties.saveIfNeeded();
+    }
+
+    void systemRequestedQuit() override {
+        if (mainWindow != nullptr) {
+            mainWindow->pluginHolder->savePluginState();
+        }
+
+        if (ModalComponentManager::getInstance()->cancelAllModalComponents()) {
+            Timer::callAfterDelay(100, []() {
+                if (auto app = JUCEApplicationBase::getInstance()) {
+                    app->systemRequestedQuit();
+                }
+            });
+        } else {
+            quit();
+        }
+    }
+
+private:
+    ApplicationProperties appProperties;
+    ConsoleApplication commands;
+    std::unique_ptr<StandaloneFilterWindow> mainWindow;
+};
+
+//==============================================================================
+JUCEApplicationBase* juce_CreateApplication();
+JUCEApplicationBase* juce_CreateApplication() { return new PantheonStandaloneApp(); }
+
+#endif
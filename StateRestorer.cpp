@@ -0,0 +1,227 @@
+#include "StateRestorer.h"
+#include <algorithm>
+#include <cmath>
+
+StateRestorer::StateRestorer(AudioProcessorValueTreeState& state, process::Parameters& values)
+    : apvts(state)
+    , parameters(values)
+    , stateType(state.state.getType().toString())
+{
+    thread->addTimeSliceClient(this);
+}
+
+StateRestorer::~StateRestorer() {
+    // waits for a running decode to finish
+    thread->removeTimeSliceClient(this);
+    cancelPendingUpdate();
+}
+
+//==============================================================================
+void StateRestorer::submit(const void* data, int sizeInBytes) {
+    auto block = std::make_shared<const MemoryBlock>(data, (size_t)jmax(0, sizeInBytes));
+
+    {
+        const SpinLock::ScopedLockType sl(lock);
+        std::swap(submitted, block);
+        ++submittedGeneration;
+        hasData = true;
+    }
+
+    thread->moveToFrontOfQueue(this);
+}
+
+void StateRestorer::pickUp() noexcept {
+    const SpinLock::ScopedTryLockType sl(lock);
+
+    if (! sl.isLocked() || ! hasValues) {
+        return;
+    }
+
+    for (int i = 0; i < numParameters; ++i) {
+        parameters.set((process::ParameterId)i, values[i]);
+    }
+
+    hasValues = false;
+}
+
+void StateRestorer::decodeNow() {
+    std::shared_ptr<const MemoryBlock> data;
+    int64 generation;
+
+    {
+        const SpinLock::ScopedLockType sl(lock);
+
+        if (decodedGeneration == submittedGeneration) {
+            return;
+        }
+
+        // the analysis thread may be busy with this one already; whichever
+        // finishes second finds it decoded and drops its result
+        data = submitted;
+        generation = submittedGeneration;
+        hasData = false;
+    }
+
+    if (decode(data, generation)) {
+        triggerAsyncUpdate();
+    }
+}
+
+void StateRestorer::finish() {
+    decodeNow();
+    cancelPendingUpdate();
+    applyToParameters();
+}
+
+bool StateRestorer::isPending() const noexcept {
+    const SpinLock::ScopedLockType sl(lock);
+    return appliedGeneration != submittedGeneration;
+}
+
+bool StateRestorer::getPendingState(MemoryBlock& destData) const {
+    std::shared_ptr<const MemoryBlock> data;
+
+    {
+        const SpinLock::ScopedLockType sl(lock);
+
+        if (appliedGeneration == submittedGeneration) {
+            return false;
+        }
+
+        data = submitted;
+    }
+
+    destData = *data;
+    return true;
+}
+
+//==============================================================================
+int StateRestorer::useTimeSlice() {
+    std::shared_ptr<const MemoryBlock> data;
+    int64 generation;
+
+    {
+        const SpinLock::ScopedLockType sl(lock);
+
+        if (! hasData) {
+            return 500;
+        }
+
+        data = submitted;
+        generation = submittedGeneration;
+        hasData = false;
+    }
+
+    if (decode(data, generation)) {
+        triggerAsyncUpdate();
+    }
+
+    return 500;
+}
+
+bool StateRestorer::decode(const std::shared_ptr<const MemoryBlock>& data, int64 generation) {
+    // as AudioProcessorValueTreeState::replaceState, a parameter missing from
+    // the state keeps its value, say one added since an old preset was saved.
+    // That's the value of a set decoded but not yet applied, if there is one.
+    float decoded[numParameters];
+
+    {
+        const SpinLock::ScopedLockType sl(lock);
+
+        if (needsApplying) {
+            std::copy(std::begin(values), std::end(values), std::begin(decoded));
+        } else {
+            for (int i = 0; i < numParameters; ++i) {
+                decoded[i] = parameters.get((process::ParameterId)i);
+            }
+        }
+    }
+
+    const auto xml = AudioProcessor::getXmlFromBinary(data->getData(), (int)data->getSize());
+    const auto isValid = xml != nullptr && xml->hasTagName(stateType);
+
+    if (isValid) {
+        for (auto* child : xml->getChildWithTagNameIterator("PARAM")) {
+            process::ParameterId id;
+
+            if (! process::Parameters::findId(child->getStringAttribute("id").toRawUTF8(), id)) {
+                continue;
+            }
+
+            const auto& info = process::Parameters::getInfo(id);
+            const auto value = (float)child->getDoubleAttribute("value", info.defaultValue);
+
+            if (std::isfinite(value)) {
+                decoded[(int)id] = jlimit(info.minimum, info.maximum, value);
+            }
+        }
+    }
+
+    std::shared_ptr<const MemoryBlock> released;
+    const SpinLock::ScopedLockType sl(lock);
+
+    if (generation <= decodedGeneration) {
+        return false;
+    }
+
+    decodedGeneration = generation;
+
+    // a state that doesn't parse is ignored, as before; whatever was decoded earlier still goes through
+    if (! isValid) {
+        if (! needsApplying) {
+            appliedGeneration = generation;
+        }
+
+        if (appliedGeneration == submittedGeneration) {
+            std::swap(released, submitted);
+        }
+
+        return false;
+    }
+
+    std::copy(std::begin(decoded), std::end(decoded), std::begin(values));
+    hasValues = needsApplying = true;
+    return true;
+}
+
+//==============================================================================
+void StateRestorer::handleAsyncUpdate() {
+    applyToParameters();
+}
+
+void StateRestorer::applyToParameters() {
+    float applied[numParameters];
+    std::shared_ptr<const MemoryBlock> released;
+
+    {
+        const SpinLock::ScopedLockType sl(lock);
+
+        if (! needsApplying) {
+            return;
+        }
+
+        // NOTE: the audio thread mustn't pick these up after this point, or it
+        // would undo whatever moves the parameters between now and its next block.
+        std::copy(std::begin(values), std::end(values), std::begin(applied));
+        hasValues = needsApplying = false;
+        appliedGeneration = decodedGeneration;
+
+        if (appliedGeneration == submittedGeneration) {
+            std::swap(released, submitted);
+        }
+    }
+
+    for (int i = 0; i < numParameters; ++i) {
+        auto* parameter = apvts.getParameter(process::Parameters::getInfo((process::ParameterId)i).id);
+
+        if (parameter == nullptr) {
+            continue;
+        }
+
+        const auto value = parameter->convertTo0to1(applied[i]);
+
+        if (value != parameter->getValue()) {
+            parameter->setValueNotifyingHost(value);
+        }
+    }
+}
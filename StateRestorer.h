@@ -0,0 +1,75 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+
+#include "DelayAligner.h"
+#include "Parameters.h"
+
+//==============================================================================
+// Takes setStateInformation off the thread that calls it. submit() only keeps
+// the bytes; the shared analysis thread decodes and validates them into one
+// value per parameter. The audio thread then picks the whole set up at the
+// start of a block, and the message thread brings the parameters in line with
+// it once, notifying only the ones that changed. A submit() before either has
+// happened supersedes the one pending, so a burst of restores costs one pickup
+// and one GUI refresh.
+class StateRestorer : private TimeSliceClient, private AsyncUpdater
+{
+public:
+    StateRestorer(AudioProcessorValueTreeState&, process::Parameters&);
+    ~StateRestorer() override;
+
+    // any thread; copies the data and returns
+    void submit(const void* data, int sizeInBytes);
+
+    // audio thread, before the block: applies a decoded set, if there is one.
+    // If the lock is taken it's left for the next block.
+    void pickUp() noexcept;
+
+    // decodes the latest submitted state on the calling thread if that hasn't
+    // happened yet, for offline rendering, where the next block must have it
+    void decodeNow();
+
+    // decodeNow(), then updates the parameters as the message thread would; for prepareToPlay
+    void finish();
+
+    // from submit() until the parameters have caught up
+    bool isPending() const noexcept;
+
+    // the data submitted last while it's pending, so saving mid-restore returns what was loaded
+    bool getPendingState(MemoryBlock&) const;
+
+private:
+    //==============================================================================
+    static constexpr int numParameters = process::Parameters::numParameters;
+
+    int useTimeSlice() override;
+    void handleAsyncUpdate() override;
+
+    // true if there's something new for the message thread
+    bool decode(const std::shared_ptr<const MemoryBlock>&, int64 generation);
+    void applyToParameters();
+
+    //==============================================================================
+    AudioProcessorValueTreeState& apvts;
+    process::Parameters& parameters;
+    const String stateType;
+
+    // handed over between the threads
+    mutable SpinLock lock;
+    std::shared_ptr<const MemoryBlock> submitted;
+    int64 submittedGeneration { 0 };
+    int64 decodedGeneration { 0 };
+    int64 appliedGeneration { 0 };
+    bool hasData { false };             // for the analysis thread
+    bool hasValues { false };           // for the audio thread
+    bool needsApplying { false };       // for the message thread
+    float values[numParameters] {};
+
+    SharedResourcePointer<process::AnalysisThread> thread;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StateRestorer)
+};
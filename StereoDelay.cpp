@@ -0,0 +1,252 @@
+#include "StereoDelay.h"
+
+namespace process {
+    //==============================================================================
+    int StereoDelay::getMaximumDelay(double sampleRate, double maximumDelayInMilliseconds) noexcept {
+        return jmax(1, (int)std::ceil(sampleRate * maximumDelayInMilliseconds * 0.001));
+    }
+
+    int StereoDelay::getBufferLength(int maximumDelayInSamples) noexcept {
+        // the Lagrange taps reach two frames behind the longest delay
+        return nextPowerOfTwo(maximumDelayInSamples + 3);
+    }
+
+    size_t StereoDelay::getArenaBytes(double sampleRate, double maximumDelayInMilliseconds) noexcept {
+        const auto length = getBufferLength(getMaximumDelay(sampleRate, maximumDelayInMilliseconds));
+        return Arena::sizeFor<float>((size_t)length * 2);
+    }
+
+    void StereoDelay::prepare(Arena& arena, double sampleRate, double maximumDelayInMilliseconds) {
+        maxDelayInSamples = getMaximumDelay(sampleRate, maximumDelayInMilliseconds);
+        bufferLength = getBufferLength(maxDelayInSamples);
+        mask = bufferLength - 1;
+
+        buffer = arena.take<float>((size_t)bufferLength * 2);
+
+        for (int ch = 0; ch < 2; ++ch) {
+            setDelay(ch, 0.f);
+            lastOutputs[ch] = 0.f;
+        }
+
+        writeIndex = 0;
+    }
+
+    void StereoDelay::reset() {
+        if (buffer != nullptr) {
+            FloatVectorOperations::clear(buffer, bufferLength * 2);
+        }
+
+        lastOutputs[0] = lastOutputs[1] = 0.f;
+        writeIndex = 0;
+    }
+
+    void StereoDelay::setInterpolation(Interpolation newInterpolation) noexcept {
+        if (newInterpolation == interpolation) {
+            return;
+        }
+
+        interpolation = newInterpolation;
+
+        for (int ch = 0; ch < 2; ++ch) {
+            fixedTaps[ch] = getTaps(interpolation, (float)delayInteger[ch] + delayFraction[ch]);
+        }
+    }
+
+    void StereoDelay::setDelay(int channel, float newDelayInSamples) noexcept {
+        jassert(isPositiveAndBelow(channel, 2));
+
+        const auto delay = jlimit(0.f, (float)maxDelayInSamples, newDelayInSamples);
+        const auto whole = (int)delay;
+
+        delayInteger[channel] = whole;
+        delayFraction[channel] = delay - (float)whole;
+        fixedTaps[channel] = getTaps(interpolation, delay);
+    }
+
+    void StereoDelay::process(float* left, float* right, int numSamples) noexcept {
+        if (delayFraction[0] == 0.f && delayFraction[1] == 0.f) {
+            processFrames<false>(left, right, numSamples);
+            return;
+        }
+
+        switch (interpolation) {
+            case Interpolation::Linear:     processFrames<true>(left, right, numSamples); break;
+            case Interpolation::Lagrange:   processTaps<Interpolation::Lagrange, false>(left, right, nullptr, numSamples); break;
+            case Interpolation::Thiran:     processTaps<Interpolation::Thiran, false>(left, right, nullptr, numSamples); break;
+        }
+    }
+
+    void StereoDelay::process(float* left, float* right, const float* leftDelays, const float* rightDelays, int numSamples) noexcept {
+        switch (interpolation) {
+            case Interpolation::Linear:     processChunks<Interpolation::Linear>(left, right, leftDelays, rightDelays, numSamples); break;
+            case Interpolation::Lagrange:   processChunks<Interpolation::Lagrange>(left, right, leftDelays, rightDelays, numSamples); break;
+            case Interpolation::Thiran:     processChunks<Interpolation::Thiran>(left, right, leftDelays, rightDelays, numSamples); break;
+        }
+    }
+
+    void StereoDelay::applyResponse(ResponseGrid& grid, int channel, float delayInSamples, Interpolation type) noexcept {
+        const auto taps = getTaps(type, jmax(0.f, delayInSamples));
+
+        grid.multiplyDelay(channel, taps.base);
+
+        if (type == Interpolation::Lagrange) {
+            grid.multiplyFir(channel, taps.c, 4);
+        } else if (taps.c[0] != 1.f || taps.feedback != 0.f) {
+            grid.multiplyFirstOrder(channel, taps.c[0], taps.c[1], taps.feedback);
+        }
+    }
+
+    //==============================================================================
+    // NOTE: the delay is clamped to [0, maximum] by the caller. No branches, only
+    // selects, so the per-sample loop in processChunks() vectorises.
+    template <StereoDelay::Interpolation type>
+    forcedinline StereoDelay::Taps StereoDelay::getTaps(float delay) noexcept {
+        const auto whole = (int)delay;
+        Taps taps { whole, {}, 0.f };
+
+        if constexpr (type == Interpolation::Linear) {
+            // current + frac * (previous - current) is (1 - frac) z^-n + frac z^-(n + 1)
+            const auto fraction = delay - (float)whole;
+
+            taps.c[0] = 1.f - fraction;
+            taps.c[1] = fraction;
+        } else if constexpr (type == Interpolation::Lagrange) {
+            // taps at n - 1 to n + 2 put the delay between the middle two, where
+            // the curve is flattest; below one sample they start at 0 instead
+            taps.base = jmax(0, whole - 1);
+
+            const auto d = delay - (float)taps.base;
+            const auto d1 = d - 1.f;
+            const auto d2 = d - 2.f;
+            const auto d3 = d - 3.f;
+
+            taps.c[0] = d1 * d2 * d3 * (-1.f / 6.f);
+            taps.c[1] = d * d2 * d3 * 0.5f;
+            taps.c[2] = d * d1 * d3 * -0.5f;
+            taps.c[3] = d * d1 * d2 * (1.f / 6.f);
+        } else {
+            // (a + z^-1) / (1 + a z^-1) delays low frequencies by d with
+            // a = (1 - d) / (1 + d), best kept within [0.5, 1.5), after base whole
+            // samples; a whole delay gives d = 1, a = 0, and only 0 needs the
+            // plain tap instead, a = 1 would put the pole on nyquist
+            taps.base = jmax(0, (int)(delay + 0.5f) - 1);
+
+            const auto d = delay - (float)taps.base;
+            const auto a = (1.f - d) / (1.f + d);
+            const auto isZero = delay == 0.f;
+
+            taps.c[0] = isZero ? 1.f : a;
+            taps.c[1] = isZero ? 0.f : 1.f;
+            taps.feedback = isZero ? 0.f : a;
+        }
+
+        return taps;
+    }
+
+    StereoDelay::Taps StereoDelay::getTaps(Interpolation type, float delay) noexcept {
+        switch (type) {
+            case Interpolation::Lagrange:   return getTaps<Interpolation::Lagrange>(delay);
+            case Interpolation::Thiran:     return getTaps<Interpolation::Thiran>(delay);
+            case Interpolation::Linear:     break;
+        }
+
+        return getTaps<Interpolation::Linear>(delay);
+    }
+
+    //==============================================================================
+    template <bool isFractional>
+    void StereoDelay::processFrames(float* left, float* right, int numSamples) noexcept {
+        auto* frames = buffer;
+        float* io[2] = {left, right};
+
+        for (int i = 0; i < numSamples; ++i) {
+            frames[writeIndex << 1] = left[i];
+            frames[(writeIndex << 1) | 1] = right[i];
+
+            for (int ch = 0; ch < 2; ++ch) {
+                const auto readIndex = (writeIndex - delayInteger[ch]) & mask;
+                const auto current = frames[(readIndex << 1) | ch];
+
+                if constexpr (isFractional) {
+                    const auto previous = frames[(((readIndex - 1) & mask) << 1) | ch];
+                    io[ch][i] = current + delayFraction[ch] * (previous - current);
+                } else {
+                    io[ch][i] = current;
+                }
+            }
+
+            writeIndex = (writeIndex + 1) & mask;
+        }
+
+        if (numSamples > 0) {
+            lastOutputs[0] = left[numSamples - 1];
+            lastOutputs[1] = right[numSamples - 1];
+        }
+    }
+
+    template <StereoDelay::Interpolation type>
+    void StereoDelay::processChunks(float* left, float* right, const float* leftDelays, const float* rightDelays, int numSamples) noexcept {
+        const float* delays[2] = {leftDelays, rightDelays};
+        const auto maximum = (float)maxDelayInSamples;
+
+        TapChunk chunk;
+
+        for (int start = 0; start < numSamples; start += chunkSize) {
+            const auto num = jmin(chunkSize, numSamples - start);
+
+            // the taps first, in flat loops with no ring access, so they vectorise
+            for (int ch = 0; ch < 2; ++ch) {
+                const auto* delay = delays[ch] + start;
+
+                for (int i = 0; i < num; ++i) {
+                    const auto taps = getTaps<type>(jlimit(0.f, maximum, delay[i]));
+
+                    chunk.base[ch][i] = taps.base;
+                    chunk.c[ch][0][i] = taps.c[0];
+                    chunk.c[ch][1][i] = taps.c[1];
+                    chunk.c[ch][2][i] = taps.c[2];
+                    chunk.c[ch][3][i] = taps.c[3];
+                    chunk.feedback[ch][i] = taps.feedback;
+                }
+            }
+
+            processTaps<type, true>(left + start, right + start, &chunk, num);
+        }
+    }
+
+    template <StereoDelay::Interpolation type, bool isModulated>
+    void StereoDelay::processTaps(float* left, float* right, const TapChunk* chunk, int numSamples) noexcept {
+        auto* frames = buffer;
+        float* io[2] = {left, right};
+
+        const auto read = [frames, this](int index, int ch) {
+            return frames[((index & mask) << 1) | ch];
+        };
+
+        for (int i = 0; i < numSamples; ++i) {
+            frames[writeIndex << 1] = left[i];
+            frames[(writeIndex << 1) | 1] = right[i];
+
+            for (int ch = 0; ch < 2; ++ch) {
+                const auto& fixed = fixedTaps[ch];
+                const auto coefficient = [&](int k) { return isModulated ? chunk->c[ch][k][i] : fixed.c[k]; };
+
+                const auto readIndex = writeIndex - (isModulated ? chunk->base[ch][i] : fixed.base);
+                auto y = coefficient(0) * read(readIndex, ch) + coefficient(1) * read(readIndex - 1, ch);
+
+                if constexpr (type == Interpolation::Lagrange) {
+                    y += coefficient(2) * read(readIndex - 2, ch) + coefficient(3) * read(readIndex - 3, ch);
+                }
+
+                if constexpr (type == Interpolation::Thiran) {
+                    y -= (isModulated ? chunk->feedback[ch][i] : fixed.feedback) * lastOutputs[ch];
+                }
+
+                lastOutputs[ch] = y;
+                io[ch][i] = y;
+            }
+
+            writeIndex = (writeIndex + 1) & mask;
+        }
+    }
+}
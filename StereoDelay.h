@@ -0,0 +1,111 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "Arena.h"
+#include "ResponseGrid.h"
+
+namespace process {
+    //==============================================================================
+    // Stereo delay line backed by a single contiguous ring of interleaved {L, R}
+    // frames. The ring length is a power of two so wrapping is a mask, and it is
+    // sized from a maximum delay in milliseconds, not from the host block size.
+    //
+    // Fractional delays are read through one of three interpolators. Linear
+    // dulls the top octave at half a sample; third-order Lagrange keeps it far
+    // flatter, at four taps; the first-order Thiran allpass keeps it exactly
+    // flat, at the cost of phase error near nyquist and a recursion that rings
+    // briefly when the delay jumps. Whole-sample delays are exact with any of
+    // them.
+    class StereoDelay {
+    public:
+        enum class Interpolation {
+            Linear = 0,
+            Lagrange,
+            Thiran,
+        };
+
+        // samples per run of the per-sample taps, computed ahead of the ring reads
+        static constexpr int chunkSize = 64;
+
+        StereoDelay() = default;
+
+        // arena bytes prepare() takes for the ring
+        static size_t getArenaBytes(double sampleRate, double maximumDelayInMilliseconds) noexcept;
+
+        void prepare(Arena&, double sampleRate, double maximumDelayInMilliseconds);
+        void reset();
+
+        void setInterpolation(Interpolation) noexcept;
+        Interpolation getInterpolation() const noexcept { return interpolation; }
+
+        void setDelay(int channel, float newDelayInSamples) noexcept;
+        float getMaximumDelayInSamples() const noexcept { return static_cast<float>(maxDelayInSamples); }
+
+        // at the delays from setDelay()
+        void process(float* left, float* right, int numSamples) noexcept;
+
+        // at a delay per sample and channel, e.g. for a sweep; setDelay() still
+        // holds for the next call without them
+        void process(float* left, float* right, const float* leftDelays, const float* rightDelays, int numSamples) noexcept;
+
+        // what process() does to one channel at this delay, interpolation included
+        static void applyResponse(ResponseGrid&, int channel, float delayInSamples, Interpolation = Interpolation::Linear) noexcept;
+
+        static int getMaximumDelay(double sampleRate, double maximumDelayInMilliseconds) noexcept;
+
+    private:
+        //==============================================================================
+        // out[n] = sum of c[k] * in[n - base - k] - feedback * out[n - 1]
+        struct Taps {
+            int base;
+            float c[4];
+            float feedback;
+        };
+
+        template <Interpolation>
+        static Taps getTaps(float delayInSamples) noexcept;
+        static Taps getTaps(Interpolation, float delayInSamples) noexcept;
+
+        // a chunk of per-sample taps, channel-major so each row is one flat loop
+        struct TapChunk {
+            int base[2][chunkSize];
+            float c[2][4][chunkSize];
+            float feedback[2][chunkSize];
+        };
+
+        template <bool isFractional>
+        void processFrames(float* left, float* right, int numSamples) noexcept;
+
+        template <Interpolation>
+        void processChunks(float* left, float* right, const float* leftDelays, const float* rightDelays, int numSamples) noexcept;
+
+        // from the chunk when modulated, else from fixedTaps
+        template <Interpolation, bool isModulated>
+        void processTaps(float* left, float* right, const TapChunk*, int numSamples) noexcept;
+
+        //==============================================================================
+        static int getBufferLength(int maximumDelayInSamples) noexcept;
+
+        //==============================================================================
+        float* buffer { nullptr };
+        int bufferLength { 0 };
+        int mask { 0 };
+        int writeIndex { 0 };
+        int maxDelayInSamples { 0 };
+
+        Interpolation interpolation { Interpolation::Linear };
+
+        int delayInteger[2] {};
+        float delayFraction[2] {};
+
+        // the setDelay() taps, for Lagrange and Thiran
+        Taps fixedTaps[2] {};
+
+        // for the Thiran recursion, kept up by every path so switching is seamless
+        float lastOutputs[2] {};
+
+        //==============================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StereoDelay)
+    };
+}
@@ -0,0 +1,114 @@
+#include "WorkStealingPool.h"
+
+//==============================================================================
+WorkStealingPool::WorkStealingPool(int numThreads) {
+    for (int i = 0; i < jmax(1, numThreads); ++i) {
+        workers.push_back(std::make_unique<Worker>(*this, i));
+    }
+
+    for (auto& worker : workers) {
+        worker->startThread();
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    for (auto& worker : workers) {
+        worker->signalThreadShouldExit();
+        worker->wakeUp.signal();
+    }
+
+    for (auto& worker : workers) {
+        worker->stopThread(1000);
+    }
+}
+
+void WorkStealingPool::runBatch(std::vector<Job>& jobs) {
+    if (jobs.empty()) {
+        return;
+    }
+
+    batchFinished.reset();
+    pendingJobs = (int)jobs.size();
+
+    const auto numWorkers = workers.size();
+
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        auto& worker = *workers[i % numWorkers];
+        const ScopedLock sl(worker.lock);
+        worker.queue.push_back(&jobs[i]);
+    }
+
+    for (auto& worker : workers) {
+        worker->wakeUp.signal();
+    }
+
+    batchFinished.wait();
+}
+
+//==============================================================================
+WorkStealingPool::Job* WorkStealingPool::popOwn(int index) {
+    auto& worker = *workers[(size_t)index];
+    const ScopedLock sl(worker.lock);
+
+    if (worker.queue.empty()) {
+        return nullptr;
+    }
+
+    auto* job = worker.queue.front();
+    worker.queue.pop_front();
+
+    return job;
+}
+
+WorkStealingPool::Job* WorkStealingPool::steal(int thiefIndex) {
+    const auto numWorkers = (int)workers.size();
+
+    for (int offset = 1; offset < numWorkers; ++offset) {
+        auto& victim = *workers[(size_t)((thiefIndex + offset) % numWorkers)];
+        const ScopedTryLock sl(victim.lock);
+
+        if (sl.isLocked() && ! victim.queue.empty()) {
+            auto* job = victim.queue.back();
+            victim.queue.pop_back();
+
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
+void WorkStealingPool::finishedJob() {
+    if (--pendingJobs == 0) {
+        batchFinished.signal();
+    }
+}
+
+//==============================================================================
+WorkStealingPool::Worker::Worker(WorkStealingPool& p, int i)
+    : Thread("Pantheon worker " + String(i))
+    , pool(p)
+    , index(i)
+{
+}
+
+void WorkStealingPool::Worker::run() {
+    while (! threadShouldExit()) {
+        auto* job = pool.popOwn(index);
+
+        if (job == nullptr) {
+            job = pool.steal(index);
+        }
+
+        if (job != nullptr) {
+            (*job)();
+            pool.finishedJob();
+            continue;
+        }
+
+        // nothing left to run or steal until the next batch comes in. While
+        // the batch is still running a queue can only look empty because its
+        // lock was busy, so check again shortly rather than spinning.
+        wakeUp.wait(pool.pendingJobs.load() == 0 ? 100 : 1);
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+// Fixed set of workers, each with its own job queue. A batch is dealt out
+// round-robin in the order given, so callers sort it by deadline; a worker runs
+// its own queue front to back and, once empty, steals from the back of the
+// others.
+class WorkStealingPool {
+public:
+    using Job = std::function<void()>;
+
+    explicit WorkStealingPool(int numThreads = SystemStats::getNumCpus());
+    ~WorkStealingPool();
+
+    int getNumThreads() const noexcept { return (int)workers.size(); }
+
+    // blocks until every job of the batch has run
+    void runBatch(std::vector<Job>& jobs);
+
+private:
+    //==============================================================================
+    class Worker : public Thread {
+    public:
+        Worker(WorkStealingPool&, int index);
+        void run() override;
+
+        CriticalSection lock;
+        std::deque<Job*> queue;
+        WaitableEvent wakeUp;
+
+    private:
+        WorkStealingPool& pool;
+        const int index;
+    };
+
+    //==============================================================================
+    Job* popOwn(int index);
+    Job* steal(int thiefIndex);
+    void finishedJob();
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<int> pendingJobs { 0 };
+    WaitableEvent batchFinished;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WorkStealingPool)
+};